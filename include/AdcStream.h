@@ -0,0 +1,60 @@
+// ============================================================================
+// AdcStream.h - Continuous DMA capture of the mic pins
+// ============================================================================
+#ifndef ADC_STREAM_H
+#define ADC_STREAM_H
+
+#include <Arduino.h>
+#include <driver/adc.h>
+
+// The ADC's digital controller converts the pins in turn at a fixed rate
+// and DMAs the readings into a pool owned by the driver, so sampling goes
+// on whatever the reading task is doing. read() blocks (it does not spin)
+// until the frames are there. Work between reads may take as long as the
+// pool lasts; past that the driver drops conversions and getOverruns()
+// counts the reads it flagged.
+class AdcStream {
+public:
+    static const int MAX_CHANNELS = 2;
+    static const int CONVERSION_BYTES = sizeof(adc_digi_output_data_t);
+    static const uint32_t READ_TIMEOUT_MS = 100;
+
+private:
+    static const int BLOCK_CONVERSIONS = 256;   // Per DMA interrupt and per driver read
+
+    int channelCount = 0;
+    uint8_t channels[MAX_CHANNELS];
+    bool running = false;
+
+    // Conversions from the last driver read not yet handed out
+    uint8_t block[BLOCK_CONVERSIONS * CONVERSION_BYTES];
+    uint32_t blockLength = 0;
+    uint32_t blockIndex = 0;
+
+    // Readings of the frame being assembled
+    uint16_t partial[MAX_CHANNELS];
+    int partialCount = 0;
+
+    uint32_t overruns = 0;
+    uint32_t stalls = 0;
+
+    bool fill(uint32_t timeoutMs);
+
+public:
+    // pins: ADC1 pins, one per channel; poolFrames: slack for the reader
+    bool begin(const int* pins, int count, uint32_t frameRate, uint32_t poolFrames);
+    void end();
+    bool isRunning() const { return running; }
+
+    // count frames of raw readings, channels interleaved. False if the
+    // ADC stopped delivering; the missing frames repeat the last reading.
+    bool read(uint16_t* raw, int count);
+
+    // Throws away everything captured so far, overflows included
+    void drain();
+
+    uint32_t getOverruns() const { return overruns; }
+    uint32_t getStalls() const { return stalls; }
+};
+
+#endif
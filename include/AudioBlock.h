@@ -0,0 +1,53 @@
+// ============================================================================
+// AudioBlock.h - Interleaved multi-channel sample block + layout kernels
+// ============================================================================
+#ifndef AUDIO_BLOCK_H
+#define AUDIO_BLOCK_H
+
+#include <Arduino.h>
+#include "SampleView.h"
+
+// Frames are stored interleaved (c0 c1 c0 c1 ...), the order the ADC/I2S
+// DMA delivers them. Per-channel readers either take a strided view (no
+// copy) or deinterleave a span into planar scratch when they need it.
+class AudioBlock {
+private:
+    int16_t* frames = nullptr;
+    int channels = 0;
+    int capacity = 0;       // Frames
+    int length = 0;         // Frames written so far
+
+public:
+    bool allocate(int channels, int capacity, const char* name);
+    void release(const char* name);
+    bool isAllocated() const { return frames != nullptr; }
+
+    void clear() { length = 0; }
+    int getChannels() const { return channels; }
+    int getCapacity() const { return capacity; }
+    int getLength() const { return length; }
+    const int16_t* data() const { return frames; }
+
+    // Slot for frame i; call commit() once samples are written
+    int16_t* frameAt(int i) { return &frames[i * channels]; }
+    void commit(int count);
+
+    // Drops the oldest count frames, sliding the rest to the front
+    void discard(int count);
+
+    // Bulk writes from either layout; return frames accepted
+    int appendInterleaved(const int16_t* in, int count);
+    int appendPlanar(const int16_t* ch0, const int16_t* ch1, int count);
+
+    // Zero-copy strided view of one channel
+    SampleView channel(int c) const { return SampleView(frames + c, length, channels); }
+
+    // Planar copy of frames [start, start + count) for two-channel blocks
+    void copyChannels(int start, int count, int16_t* ch0, int16_t* ch1) const;
+
+    // Layout kernels for stereo, unrolled by four frames
+    static void deinterleave2(const int16_t* in, int16_t* ch0, int16_t* ch1, int count);
+    static void interleave2(const int16_t* ch0, const int16_t* ch1, int16_t* out, int count);
+};
+
+#endif
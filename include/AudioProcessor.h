@@ -7,6 +7,10 @@
 #include <Arduino.h>
 #include <math.h>
 
+#include "SampleView.h"
+
+class SpectralFrameStore;
+
 // MFCC parameters matching Model training
 const int N_FFT = 256;
 const int HOP_LENGTH = 200;
@@ -24,13 +28,34 @@ private:
     float mel_spectrum[MEL_BINS];
     float log_mel[MEL_BINS];
     
-    void computeFFT(float* real, float* imag, int n);
+    // Shared twiddle table for every FFT size up to N_FFT
+    static float twiddle_cos[N_FFT / 2];
+    static float twiddle_sin[N_FFT / 2];
+    static bool twiddles_ready;
+    
+    static void initTwiddles();
+    
+    void extractFrames(const SampleView& audio, float mfcc_features[][N_MFCC], int firstFrame,
+                       const SampleView* mic1, const SampleView* mic2, SpectralFrameStore* store);
+    void addSpectra(const SampleView* mic1, const SampleView* mic2, int start,
+                    SpectralFrameStore* store);
     
 public:
     AudioProcessor();
     
-    // Accepts int16_t directly (matching ESP32 mic format)
-    void extractMFCC(const int16_t* audio, int length, float mfcc_features[][N_MFCC]);
+    // In-place complex FFT; n must be a power of two no larger than N_FFT
+    static void computeFFT(float* real, float* imag, int n);
+    
+    // Accepts int16_t directly (matching ESP32 mic format), through a view so
+    // resampled input needs no copy
+    void extractMFCC(const SampleView& audio, float mfcc_features[][N_MFCC]);
+    
+    // Frames [firstFrame, N_FRAMES) only; earlier rows of mfcc_features are
+    // left as they are. With a mic pair, each of those frames also adds the
+    // pair's band spectra to store; both mics share one FFT per frame.
+    void extractMFCCFrom(const SampleView& audio, float mfcc_features[][N_MFCC], int firstFrame,
+                         const SampleView* mic1 = nullptr, const SampleView* mic2 = nullptr,
+                         SpectralFrameStore* store = nullptr);
 };
 
 #endif
\ No newline at end of file
@@ -4,17 +4,41 @@
 #ifndef AUDIO_RECORDER_H
 #define AUDIO_RECORDER_H
 #include <Arduino.h>
+#include "SampleView.h"
+#include "AudioBlock.h"
+#include "Beamformer.h"
+#include "AutoGain.h"
 
 const int micPin1 = A0;
 const int micPin2 = A1;
 const int SAMPLE_RATE = 16000;      //16kHz
 const int BUFFER_SIZE = 16000;      // 1 second buffer for Wake Up Word
 const int BUFFER_SIZE_MIC1 = 48000; // 3 second buffer for Wit.ai command
+const int CAPTURE_CHUNK = 100;      // Frames read per loop call (6.25 ms)
+// The wake-word window slides by WAKE_HOP instead of starting over after
+// each inference: about 4 windows a second instead of 1. A ~600 ms wake
+// word then lies whole inside at least two windows rather than often
+// straddling two back-to-back ones. Each window's features and inference
+// have to fit in the hop; 4x the windows is also 4x the chances of a false
+// accept per hour at any given threshold.
+const int WAKE_HOP = BUFFER_SIZE / 4;   // New frames per wake-word window (250 ms)
+
+// Per-chunk work (listeners, streaming analysis) runs while the ADC's DMA
+// fills the capture pool. Bursts may run up to the pool's length, but the
+// steady per-chunk load has to stay a small slice of a chunk so the reader
+// catches up between bursts
+const uint32_t CHUNK_MICROS = CAPTURE_CHUNK * 1000000UL / SAMPLE_RATE;
+const uint32_t CHUNK_BUDGET_MICROS = CHUNK_MICROS / 10;
+
+// Sees every captured chunk (interleaved mic 1/mic 2 frames) whichever
+// loop is recording, e.g. the DTMF decoder
+typedef void (*CaptureListener)(const int16_t* frames, int count, void* context);
 
 extern int16_t* ringBuffer1;
-extern int16_t* ringBuffer2;
-extern int16_t* pitchBuffer1;
-extern int16_t* pitchBuffer2;
+extern AudioBlock captureBlock;
+extern Beamformer beamformer;
+extern AutoGain micGain;
+extern AutoGain wakeGain;
 
 extern volatile bool continuousRecording;
 extern volatile bool shouldRecord;
@@ -26,8 +50,22 @@ bool allocateWitBuffers();
 void freeBuffers();
 
 void MIC_setup();
+bool MIC_isReady();
 bool MIC_loop(); 
+bool MIC_command(char command);
+void MIC_setListener(CaptureListener listener, void* context);
+void MIC_readFrames(int16_t* frames, int count, AutoGain& gain = micGain);
+void MIC_chargeWork(uint32_t micros);
+void MIC_printLoad(const char* label);
+void MIC_drain();
+void MIC_stream();
+SampleView MIC_beamView();
+int MIC_beamAdvance();
+SampleView MIC_pitchView(int channel);
+void MIC_printLevels(const char* label, AutoGain& gain = micGain);
 void acknowledgeData(); 
 void startRecording();
+void continueRecording();
+void stopRecording();
 
 #endif
\ No newline at end of file
@@ -0,0 +1,71 @@
+// ============================================================================
+// AutoGain.h - ADC front end: DC tracking, block AGC, saturation counters
+// ============================================================================
+#ifndef AUTO_GAIN_H
+#define AUTO_GAIN_H
+
+#include <Arduino.h>
+
+// Turns raw 12-bit ADC readings into int16 samples in the capture loop
+// itself. Each channel tracks its own bias; both share one gain so the
+// level difference between the mics (laser evidence) survives. The gain
+// drops at once when a block peaks above TARGET_PEAK and creeps back up
+// over about a second of quieter blocks. A non-adaptive instance keeps its
+// initial gain and only tracks bias and levels.
+class AutoGain {
+public:
+    static const int MAX_CHANNELS = 2;
+    static const int32_t TARGET_PEAK = 16384;   // -6 dBFS
+    static const int32_t MIN_GAIN_Q8 = 1 << 8;
+    static const int32_t MAX_GAIN_Q8 = 64 << 8;
+
+    struct Stats {
+        uint32_t samples;       // Since the last resetStats()
+        uint32_t clipped;       // Outputs that hit the int16 rails
+        int32_t peak;           // Largest |output| before saturation
+        int32_t gainQ8;
+        int16_t dc[MAX_CHANNELS];   // Tracked ADC bias, counts
+    };
+
+private:
+    static const int DC_SHIFT = 12;         // Bias time constant, 4096 samples (~250 ms)
+    static const int RELEASE_SHIFT = 8;     // Gain +0.4% per quiet block
+
+    int32_t dcQ12[MAX_CHANNELS];
+    uint8_t primed = 0;             // Bit per channel with a seeded bias
+    bool adaptive;
+    int32_t gainQ8;
+    int32_t blockPeak = 0;
+    Stats stats;
+
+    void prime(int channel, int raw);
+
+public:
+    AutoGain(int32_t initialGainQ8 = 32 << 8, bool adaptive = true);
+
+    // One raw ADC reading in, one saturated int16 sample out
+    inline int16_t process(int channel, int raw) {
+        if (!(primed & (1 << channel))) prime(channel, raw);
+
+        int32_t& dc = dcQ12[channel];
+        dc += ((raw << 12) - dc) >> DC_SHIFT;
+
+        // Q4 input keeps the bias fraction; Q4 * Q8 >> 12 gives samples
+        int32_t y = (((raw << 4) - (dc >> 8)) * gainQ8) >> 12;
+        int32_t magnitude = y < 0 ? -y : y;
+        if (magnitude > blockPeak) blockPeak = magnitude;
+
+        stats.samples++;
+        if (y > 32767) { stats.clipped++; return 32767; }
+        if (y < -32768) { stats.clipped++; return -32768; }
+        return (int16_t)y;
+    }
+
+    // Adapts the gain from the block just processed (if adaptive)
+    void endBlock();
+
+    const Stats& getStats();
+    void resetStats();
+};
+
+#endif
@@ -0,0 +1,68 @@
+// ============================================================================
+// Beamformer.h - Two-mic delay-and-sum beamformer (fixed-point steering)
+// ============================================================================
+#ifndef BEAMFORMER_H
+#define BEAMFORMER_H
+
+#include <Arduino.h>
+#include "AudioBlock.h"
+#include "GccPhat.h"
+
+// Whichever mic hears the talker first is delayed by the measured TDOA
+// through a short windowed-sinc FIR, then averaged with the other mic.
+// Speech adds coherently; uncorrelated mic and ADC noise does not.
+class Beamformer {
+public:
+    static const int TAPS = 8;                  // Fractional-delay FIR length
+    static const int FRACTIONS = 16;            // Delay resolution, 1/16 sample
+    static const int LATENCY = TAPS / 2 - 1;    // Lookahead of the FIR, samples
+    static const uint8_t MIN_SHARPNESS = 64;    // Weaker GCC peaks keep the old steering
+
+private:
+    static const int LINE_SIZE = 32;            // > LATENCY + MAX_LAG + TAPS / 2
+    static const int LINE_MASK = LINE_SIZE - 1;
+
+    // One FIR per fractional delay, Q14 (a whole-sample tap is 1.0, which
+    // Q15 cannot hold), each summing to 1.0
+    int16_t coeffs[FRACTIONS][TAPS];
+
+    int16_t line1[LINE_SIZE];
+    int16_t line2[LINE_SIZE];
+    int position = 0;
+
+    int16_t steeringQ8 = 0;     // Positive: sound reaches mic 2 first
+    bool leadIsMic2 = false;
+    int delayWhole = 0;
+    const int16_t* delayTaps;
+
+    GccPhat gcc;
+    int16_t frame1[GccPhat::FRAME_SIZE];
+    int16_t frame2[GccPhat::FRAME_SIZE];
+
+    void design();
+    int16_t push(int16_t s1, int16_t s2);
+
+public:
+    Beamformer();
+
+    // Aim at a talker whose sound reaches mic 2 tdoaQ8/256 samples early
+    void steer(int16_t tdoaQ8);
+    int16_t getSteering() const { return steeringQ8; }
+
+    // Re-aims from the loudest GCC frame of a stereo capture; returns
+    // false (steering unchanged) when no frame has a clear direct path
+    bool steerFrom(const AudioBlock& block);
+
+    // Clears the delay lines; steering is kept
+    void reset();
+
+    // Streams count interleaved stereo frames, writing count mono samples
+    // that trail the input by LATENCY samples
+    void process(const int16_t* frames, int count, int16_t* out);
+
+    // Beam of frames [0, count) of a stereo block, lookahead compensated;
+    // frames past the end of the block read as silence
+    void render(const AudioBlock& block, int16_t* out, int count);
+};
+
+#endif
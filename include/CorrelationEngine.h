@@ -0,0 +1,51 @@
+// ============================================================================
+// CorrelationEngine.h - O(1) windowed correlation from prefix moments
+// ============================================================================
+#ifndef CORRELATION_ENGINE_H
+#define CORRELATION_ENGINE_H
+
+#include <Arduino.h>
+
+class CorrelationEngine {
+public:
+    // Raw sums over a span of samples; differences of prefixes give any span
+    struct Moments {
+        int64_t sx, sy, sxx, syy, sxy;
+    };
+
+private:
+    static const int MAX_BLOCKS = 128;
+
+    const int16_t* bufX = nullptr;
+    const int16_t* bufY = nullptr;
+    int stride = 1;                     // 2 for interleaved stereo frames
+    size_t length = 0;
+    size_t capacity = 0;
+    size_t blockSize = 1;
+
+    // prefix[k] holds the moments of [0, k * blockSize); running covers [0, length)
+    Moments prefix[MAX_BLOCKS + 1];
+    Moments running;
+
+    void accumulate(Moments& m, size_t from, size_t to) const;
+
+public:
+    // Streaming use: begin() once per capture, then extend() as samples land
+    // in x/y. Queries only see samples up to the current length.
+    void begin(const int16_t* x, const int16_t* y, size_t capacity, size_t alignment,
+               int stride = 1);
+    void extend(size_t newLength);
+    size_t getLength() const { return length; }
+
+    // Single pass over both buffers. Windows whose edges fall on multiples of
+    // alignment resolve purely from the prefix table; others scan their edges.
+    void build(const int16_t* x, const int16_t* y, size_t length, size_t alignment);
+
+    Moments moments(size_t start, size_t count) const;
+    int16_t correlationQ8(size_t start, size_t count) const;
+
+    // DC-removed correlation in Q8 (0..256) from the raw sums of n samples
+    static int16_t correlationQ8(const Moments& m, size_t n);
+};
+
+#endif
@@ -5,27 +5,19 @@
 #define DTMF_DETECTOR_H
 
 #include <Arduino.h>
+#include <atomic>
+#include "GoertzelBank.h"
+#include "Resampler.h"
 
-#define DTMF_SAMPLE_RATE 8000
-#define DTMF_BUFFER_SIZE 800      // Dynamic buffer size
-#define DTMF_DETECTION_THRESHOLD 10
+#define DTMF_SAMPLE_RATE 8000     // After decimating the 16kHz capture by 2
+#define DTMF_DECIMATE_TAPS 16     // Anti-alias FIR for the decimator
+#define DTMF_CHUNK 64             // Capture frames decimated per step
+#define DTMF_BLOCK_SIZE 205       // Goertzel sub-block (~26 ms, 39 Hz bins)
+#define DTMF_BLOCK_HOP 103        // Sub-blocks start half a block apart
+#define DTMF_DETECTION_THRESHOLD 0.65   // Per sub-block, samples normalized to full scale
 
 class DTMFDetector {
 private:
-    // Goertzel Algorithm Implementation
-    class Goertzel {
-    private:
-        float coeff;
-        float Q1, Q2;
-        float sine, cosine;
-        
-    public:
-        void init(float freq, float sampleRate);
-        void reset();
-        void processSample(float sample);
-        float getMagnitudeSquared();
-    };
-    
     // DTMF Frequencies
     static constexpr float DTMF_ROW[4] = {697, 770, 852, 941};
     static constexpr float DTMF_COL[4] = {1209, 1336, 1477, 1633};
@@ -38,19 +30,27 @@ private:
         {'*', '0', '#', 'D'}
     };
     
-    // Goertzel filters
-    Goertzel rowTones[4];
-    Goertzel colTones[4];
+    // One filter set per overlapping sub-block (rows 0-3, columns 4-7);
+    // the second starts DTMF_BLOCK_HOP samples after the first
+    struct Bank {
+        GoertzelBank filters;
+        int count;              // Samples so far; negative while waiting to start
+    };
+    Bank banks[2];
     
     // Detection parameters
     float threshold;
-    int dcOffset;
-    char lastDetected;
-    unsigned long lastDetectionTime;
+    char previousBlock;         // Verdict of the last finished sub-block
+    char heldKey;               // Reported and not yet released
+    std::atomic<char> pendingKey;   // Latest key from the capture listener
+    
+    // 16kHz capture -> 8kHz; only mic 1 is decoded, read in place from
+    // the interleaved frames
+    Resampler decimator;
+    int16_t decimated[DTMF_CHUNK / 2];
     
-    // Dynamic buffer
-    int16_t* audioBuffer;
-    bool bufferAllocated;
+    char detectTone(Bank& bank);
+    char decide(char block);
     
     // Time entry state
     String timeEntry;
@@ -59,19 +59,22 @@ private:
     
 public:
     DTMFDetector();
-    ~DTMFDetector();
-    
-    // Memory management
-    bool allocateBuffer();
-    void freeBuffer();
     
     // Initialization
     void init();
-    void calibrateDCOffset(int micPin);
     
-    // Detection
-    char detectTone();
-    char recordAndDetect(int micPin);
+    // Detection: samples stream through both banks; a key is reported once,
+    // as soon as two consecutive sub-blocks agree on it
+    void resetStream();
+    char feed(const int16_t* samples, int count);
+    
+    // Consumes interleaved 16kHz capture frames (already DC-free from the
+    // capture AGC); matches CaptureListener so it can subscribe directly
+    static void onCapture(const int16_t* frames, int count, void* context);
+    void feedCapture(const int16_t* frames, int count);
+    
+    // Key found since the last call, or '\0'
+    char takeKey();
     
     // Time entry handling
     void resetTimeEntry();
@@ -79,9 +82,5 @@ public:
     String getTimeDisplay();
     String getTimeValue();
     bool isTimeComplete();
-    
-    // Getters
-    bool isBufferAllocated() { return bufferAllocated; }
-    int getDCOffset() { return dcOffset; }
 };
 #endif
\ No newline at end of file
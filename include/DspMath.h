@@ -0,0 +1,29 @@
+// ============================================================================
+// DspMath.h - Small fixed-point helpers shared by the DSP code
+// ============================================================================
+#ifndef DSP_MATH_H
+#define DSP_MATH_H
+
+#include <stdint.h>
+
+// floor(sqrt(v)), exact for the full 64-bit range. Digit-by-digit, so it
+// costs 32 shift/compare steps and never touches the (soft) double unit.
+static inline uint32_t isqrt64(uint64_t v) {
+    uint64_t result = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+
+    while (bit > v) bit >>= 2;
+
+    while (bit) {
+        if (v >= result + bit) {
+            v -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)result;
+}
+
+#endif
@@ -0,0 +1,33 @@
+// ============================================================================
+// GccPhat.h - Inter-mic delay estimate by PHAT-weighted cross-correlation
+// ============================================================================
+#ifndef GCC_PHAT_H
+#define GCC_PHAT_H
+
+#include <Arduino.h>
+#include "AudioProcessor.h"
+
+class GccPhat {
+public:
+    static const int FRAME_SIZE = N_FFT;   // 16ms at 16kHz
+    static const int MAX_LAG = 8;          // ~17cm of mic spacing at 16kHz
+
+    struct Estimate {
+        int8_t tdoa;        // Samples; positive when sound reaches mic 2 first
+        uint8_t sharpness;  // PHAT peak height in Q8 (256 = a single clean path)
+        int16_t tdoaQ8;     // tdoa refined by a parabolic fit around the peak
+    };
+
+private:
+    float window[FRAME_SIZE];
+    float re[FRAME_SIZE];
+    float im[FRAME_SIZE];
+
+public:
+    GccPhat();
+
+    // x and y each hold FRAME_SIZE samples from mic 1 and mic 2
+    Estimate estimate(const int16_t* x, const int16_t* y);
+};
+
+#endif
@@ -0,0 +1,58 @@
+// ============================================================================
+// GoertzelBank.h - Fixed-point Goertzel filters in struct-of-arrays form
+// ============================================================================
+#ifndef GOERTZEL_BANK_H
+#define GOERTZEL_BANK_H
+
+#include <Arduino.h>
+
+// All filters step through a sample together: one array per state
+// variable, a fixed trip count over the filters, no branches, so the
+// compiler can unroll or vectorize across them. Coefficients are Q14 and
+// the whole recursion is int32: input is rounded to 8 bits first, which
+// keeps |s| < 2^16 and so the Q14 product under 2^31 over a DTMF block
+// (|s| <= 128 * 205 / sin(w) for 205 samples, lowest tone 697 Hz at 8 kHz).
+class GoertzelBank {
+public:
+    static const int FILTERS = 8;
+    static const int INPUT_SHIFT = 8;
+
+private:
+    int32_t coeffQ14[FILTERS];      // 2*cos(w), Q14
+    float coeff[FILTERS];           // Same value, for the magnitude step
+    int32_t s1[FILTERS];
+    int32_t s2[FILTERS];
+
+public:
+    // freqs holds FILTERS frequencies in Hz
+    void init(const float* freqs, float sampleRate);
+    void reset();
+
+    inline void process(const int16_t* x, int count) {
+        // Locals let the state stay in registers across samples
+        int32_t c[FILTERS], a[FILTERS], b[FILTERS];
+        for (int f = 0; f < FILTERS; f++) {
+            c[f] = coeffQ14[f];
+            a[f] = s1[f];
+            b[f] = s2[f];
+        }
+        for (int n = 0; n < count; n++) {
+            int32_t sample = (x[n] + (1 << (INPUT_SHIFT - 1))) >> INPUT_SHIFT;
+            for (int f = 0; f < FILTERS; f++) {
+                int32_t s0 = ((c[f] * a[f]) >> 14) - b[f] + sample;
+                b[f] = a[f];
+                a[f] = s0;
+            }
+        }
+        for (int f = 0; f < FILTERS; f++) {
+            s1[f] = a[f];
+            s2[f] = b[f];
+        }
+    }
+
+    // Squared magnitude of every filter, scaled by `scale` as if the input
+    // had not been pre-scaled; call once per block
+    void magnitudes(float* out, float scale) const;
+};
+
+#endif
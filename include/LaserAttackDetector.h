@@ -5,8 +5,28 @@
 #define LASER_ATTACK_DETECTOR_H
 
 #include <Arduino.h>
+#include "CorrelationEngine.h"
+#include "GccPhat.h"
+#include "SpectralFrameStore.h"
+#include "AudioBlock.h"
 
 class LaserAttackDetector {
+public:
+    struct DetectionResult {
+        bool attackDetected;
+        uint8_t confidence;
+        int16_t globalCorr;
+        uint8_t anomalyRatio;
+        int16_t minWindowCorr;
+        int8_t tdoa;               // Dominant inter-mic delay (samples)
+        uint8_t tdoaConsistency;   // % of voiced frames within 1 sample of it
+        uint8_t sharpness;         // Mean GCC-PHAT peak, Q8
+        uint8_t voicedFrames;
+        uint8_t coherence;         // Mean inter-mic band coherence, 0..255
+        uint8_t bandRatioDev;      // Worst band level shift from baseline (dB)
+        uint8_t spectralFrames;
+    };
+
 private:
     static const int WINDOW_SIZE = 800;  // 50ms at 16kHz
     static const int STRIDE = 400;       // 25ms stride
@@ -16,25 +36,73 @@ private:
     static const int GLOBAL_THRESH = 77;     // 0.3 (was 0.8) - much lower for your setup
     static const int MIN_WINDOW_THRESH = 51; // 0.2 (was 0.5)
     
+    // GCC-PHAT evidence: a real talker gives a sharp, repeatable delay,
+    // light injected into one mic gives neither
+    static const int MIN_VOICED_FRAMES = 3;
+    static const int SHARPNESS_THRESH = 51;   // 0.2 when uncalibrated
+    static const int CONSISTENCY_THRESH = 50; // %
+    
+    // Spectral evidence from the wake-word FFT frames
+    static const int MIN_SPECTRAL_FRAMES = 5;
+    static const int COHERENCE_THRESH = 64;   // ~0.25
+    static const int BAND_RATIO_DEV_DB = 12;
+    
+    // Enough for a 1 s capture at the window/stride above
+    static const int MAX_WINDOWS = 64;
+    
     // Baseline correlation from calibration
     int16_t baselineCorrelation = 135; // Default ~0.53 (your measured value)
+    uint8_t baselineSharpness = 0;     // 0 until calibrated with voiced audio
+    float baselineBandRatioDb[SpectralFrameStore::BANDS];
+    bool hasSpectralBaseline = false;
     bool isCalibrated = false;
     
-    int16_t calculateCorrelationQ8(int16_t* buf1, int16_t* buf2, int size);
+    // Prefix moments of the current capture; every window is an O(1) query
+    CorrelationEngine engine;
+    GccPhat gcc;
+    const AudioBlock* capture = nullptr;
+    int16_t gccFrame1[GccPhat::FRAME_SIZE];    // Planar scratch for one frame
+    int16_t gccFrame2[GccPhat::FRAME_SIZE];
+    
+    // Published by the feature front end; fresh once its generation moves
+    const SpectralFrameStore* spectra = nullptr;
+    uint32_t spectraGenerationAtCapture = 0;
+    
+    // Per-window correlations, filled in as the capture arrives
+    int16_t windowCorr[MAX_WINDOWS];
+    int windows = 0;
+    size_t nextWindowStart = 0;
+    
+    // Memoized result for the samples seen so far
+    DetectionResult cachedResult;
+    size_t cachedLength = 0;
+    uint32_t cachedSpectraGeneration = 0;
+    bool resultValid = false;
+    
+    static size_t gcd(size_t a, size_t b);
+    
+    // Runs GCC-PHAT on the louder windows; fills the tdoa/sharpness fields
+    void analyzeDelays(DetectionResult& result);
+    
+    // Band coherence and level ratios; bandRatioDb may be null
+    void analyzeSpectra(DetectionResult& result, float* bandRatioDb);
+    bool spectraFresh();
     
 public:
-    struct DetectionResult {
-        bool attackDetected;
-        uint8_t confidence;
-        int16_t globalCorr;
-        uint8_t anomalyRatio;
-        int16_t minWindowCorr;
-    };
+    // Frame store filled alongside MFCC extraction (see VoiceDetector)
+    void attachSpectra(const SpectralFrameStore* store) { spectra = store; }
+    
+    // Call when a new dual-mic capture starts filling block
+    void beginCapture(const AudioBlock& block);
+    
+    // Call as samples land; 'captured' is the total written so far
+    void onSamples(size_t captured);
     
-    // Calibration function
-    void calibrate(int16_t* buf1, int16_t* buf2, size_t bufferSize);
+    // Learns the mics' baseline from the current capture
+    void calibrate();
     
-    DetectionResult detectAttack(int16_t* pitchBuffer1, int16_t* pitchBuffer2, size_t bufferSize);
+    // Ready as soon as the capture completes; repeated calls are free
+    const DetectionResult& getResult();
     void printResults(const DetectionResult& result);
 };
 
@@ -0,0 +1,73 @@
+// ============================================================================
+// LcdFrameBuffer.h - Shadow framebuffer for HD44780 character LCDs
+// ============================================================================
+#ifndef LCD_FRAME_BUFFER_H
+#define LCD_FRAME_BUFFER_H
+
+#include <stdint.h>
+
+// Keeps a copy of what the panel shows and only sends cells that changed.
+// Every HD44780 byte is a slow bit-banged 4-bit transfer, so the saving is
+// one bus transaction per unchanged character.
+class LcdFrameBuffer {
+public:
+    static const int COLS = 16;
+    static const int ROWS = 2;
+
+private:
+    char shown[ROWS][COLS];    // What the panel currently displays
+    char pending[ROWS][COLS];  // What it should display after flush()
+    uint32_t dirty;            // One bit per cell, bit = row * COLS + col
+
+    unsigned long busWrites;   // setCursor commands + data bytes sent
+
+    static_assert(ROWS * COLS <= 32, "dirty bitmap is a single uint32_t");
+
+public:
+    LcdFrameBuffer();
+
+    // Mark the panel as blank, e.g. right after lcd.clear()
+    void invalidate();
+
+    // Write text at (row, col), padding with spaces up to width cells
+    void write(int row, int col, const char* text, int width);
+    void writeLine(int row, const char* text) { write(row, 0, text, COLS); }
+
+    bool isDirty() const { return dirty != 0; }
+    unsigned long getBusWrites() const { return busWrites; }
+
+    // Send dirty cells to any driver with setCursor(col, row) and write(char).
+    // Runs of dirty cells share one cursor move; a single clean cell between
+    // two runs is resent rather than paying for another cursor command.
+    template <typename Driver>
+    void flush(Driver& lcd) {
+        for (int row = 0; row < ROWS && dirty; row++) {
+            uint32_t rowBits = (dirty >> (row * COLS)) & ((1UL << COLS) - 1);
+            int cursor = -1;  // Column the panel cursor sits on, -1 = unknown
+
+            while (rowBits) {
+                int col = __builtin_ctz(rowBits);
+
+                if (cursor >= 0 && col - cursor == 1) {
+                    // Bridge a one-cell gap instead of moving the cursor
+                    lcd.write(pending[row][cursor]);
+                    shown[row][cursor] = pending[row][cursor];
+                    busWrites++;
+                } else if (col != cursor) {
+                    lcd.setCursor(col, row);
+                    busWrites++;
+                }
+
+                lcd.write(pending[row][col]);
+                shown[row][col] = pending[row][col];
+                busWrites++;
+
+                rowBits &= rowBits - 1;
+                cursor = col + 1;
+            }
+        }
+        dirty = 0;
+    }
+};
+
+#endif
@@ -4,8 +4,8 @@
 
 #include <Arduino.h>
 #include <LiquidCrystal.h>
-#include <WiFiUdp.h>
-#include <NTPClient.h>
+#include "TimeService.h"
+#include "LcdFrameBuffer.h"
 
 // LCD Pin definitions for ESP32-S3
 #define LCD_RS  4
@@ -19,34 +19,28 @@
 #define LCD_COLS 16
 #define LCD_ROWS 2
 
-// NTP Settings
-#define NTP_SERVER "pool.ntp.org"
-#define UTC_OFFSET_SEC -18000  
-// EST = -18000, PST = -28800, CET = 3600
-
 class LcdTimeDisplay {
 private:
     LiquidCrystal* lcd;
-    WiFiUDP* ntpUDP;
-    NTPClient* timeClient;
+    LcdFrameBuffer frameBuffer;
+    TimeService* clockSource;
     
-    unsigned long lastTimeUpdate;
     unsigned long lastLcdUpdate;
     const unsigned long TIME_UPDATE_INTERVAL = 1000;  // Update display every second
-    const unsigned long NTP_UPDATE_INTERVAL = 3600000; // Sync with NTP every hour
     
-    String currentStatus;
+    static void formatClock(char* out, int hours, int minutes, int seconds, int day);
     
 public:
     LcdTimeDisplay();
     ~LcdTimeDisplay();
     
-    void begin();
+    void begin(TimeService* clockSource);
     void updateStatus(const char* status);
     void updateTime();
     void forceTimeSync();
     void displayWelcomeMessage();
     void clearDisplay();
+    unsigned long getBusWrites() { return frameBuffer.getBusWrites(); }
     
     // Status messages for different states
     static const char* STATUS_WIFI_CONNECTING;
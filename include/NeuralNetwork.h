@@ -16,6 +16,8 @@ namespace tflite {
 }
 
 struct TfLiteTensor;
+class StreamingCnn;
+class WorkerPool;
 
 class NeuralNetwork {
 private:
@@ -26,12 +28,18 @@ private:
     TfLiteTensor *input;
     TfLiteTensor *output;
     uint8_t *m_tensor_arena;
+    StreamingCnn *m_streaming;
+    WorkerPool *m_workers;
 
 public:
     NeuralNetwork();
     ~NeuralNetwork();
     float *getInputBuffer();
     float predict();
+
+    // Column-cached pass over a sliding feature window (null if the model
+    // is not one StreamingCnn understands)
+    StreamingCnn *getStreaming() { return m_streaming; }
 };
 
 #endif
@@ -0,0 +1,78 @@
+// ============================================================================
+// NoiseSuppressor.h - Wiener noise suppression in the STFT domain
+// ============================================================================
+#ifndef NOISE_SUPPRESSOR_H
+#define NOISE_SUPPRESSOR_H
+
+#include <Arduino.h>
+#include "AudioProcessor.h"
+
+// Tracks a per-bin noise floor that falls quickly and rises slowly, so it
+// settles on the hum between words, and derives a decision-directed
+// Wiener gain from it. Uploads stream through process(), a 50%-overlap
+// sqrt-Hann STFT with overlap-add resynthesis on AudioProcessor::computeFFT.
+// Only the Wit.ai upload is cleaned: the wake-word model was trained on
+// unsuppressed features.
+class NoiseSuppressor {
+public:
+    static const int FRAME_SIZE = N_FFT;
+    static const int HOP = FRAME_SIZE / 2;
+    static const int LATENCY = FRAME_SIZE;      // process() output delay, samples
+
+private:
+    static constexpr float NOISE_FALL = 0.2f;       // Per-frame step toward a lower power
+    static constexpr float NOISE_RISE = 0.005f;     // Per-frame step toward a higher power
+    static constexpr float PRIOR_WEIGHT = 0.98f;    // Decision-directed smoothing of the a-priori SNR
+    static constexpr float GAIN_FLOOR = 0.15f;      // Residual noise left in, keeps it from "warbling"
+
+    float noise[FFT_BINS];
+    float cleanPower[FFT_BINS];         // Previous frame's power after the gain
+    float gain[FFT_BINS];
+    bool primed = false;
+
+    // Streaming STFT state
+    float window[FRAME_SIZE];           // sqrt-Hann; squared copies overlap-add to 1
+    float re[FRAME_SIZE];
+    float im[FRAME_SIZE];
+    float input[FRAME_SIZE];            // Last FRAME_SIZE input samples
+    float overlap[FRAME_SIZE];          // Overlap-add accumulator
+    int16_t output[HOP];                // Finished samples not yet handed out
+    int filled = 0;                     // New input samples since the last frame
+    bool leadIn = true;                 // First frame of the stream still to come
+
+    uint32_t frames = 0;
+    uint32_t lastFrameMicros = 0;
+    uint32_t maxFrameMicros = 0;
+
+    void processFrame();
+
+public:
+    NoiseSuppressor();
+
+    // Forgets the noise estimate as well as the stream
+    void reset();
+
+    // Clears the stream only; the noise estimate carries over
+    void restart();
+
+    // Updates the noise estimate from one power spectrum (FFT_BINS bins)
+    // and scales it in place by the squared gains
+    void suppress(float* power);
+
+    // Gains from the last suppress() or processed frame
+    const float* getGains() const { return gain; }
+
+    // Denoises count samples in place; output trails input by LATENCY, so
+    // the first LATENCY samples out after restart() are lead-in, not audio
+    void process(int16_t* samples, int count);
+
+    // Writes the LATENCY samples still in flight to tail and returns how
+    // many that is; the stream must be restarted before reuse
+    int flush(int16_t* tail);
+
+    uint32_t getFrameCount() const { return frames; }
+    uint32_t getLastFrameMicros() const { return lastFrameMicros; }
+    uint32_t getMaxFrameMicros() const { return maxFrameMicros; }
+};
+
+#endif
@@ -0,0 +1,19 @@
+// ============================================================================
+// ParallelConv.h - Float Conv2D kernel split by output rows across a pool
+// ============================================================================
+#ifndef PARALLEL_CONV_H
+#define PARALLEL_CONV_H
+
+#include "WorkerPool.h"
+
+struct TfLiteRegistration;
+
+// Drop-in for TFLM's CONV_2D. Float convolutions hand each output row to
+// the pool as one item and run the reference kernel on it, with the input
+// and padding offset so the row sees exactly the window it would in the
+// full loop; results match the serial kernel bit for bit. Quantized types
+// and a null pool fall through to the stock kernel, whose init and prepare
+// are reused as-is.
+TfLiteRegistration Register_PARALLEL_CONV_2D(WorkerPool* workers);
+
+#endif
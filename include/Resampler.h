@@ -0,0 +1,62 @@
+// ============================================================================
+// Resampler.h - Streaming polyphase FIR resampler (Q15, two channels)
+// ============================================================================
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+
+#include <Arduino.h>
+
+class Resampler {
+public:
+    static const int MAX_PHASES = 8;
+    static const int MAX_TAPS = 16;     // Per phase, even
+
+private:
+    int up = 1;
+    int down = 1;
+    int taps = 2;
+    bool halfBand = false;              // up=2, down=1: phase 0 is a pure delay
+
+    // taps-long filter for each output phase, Q15, oldest sample first
+    int16_t coeffs[MAX_PHASES][MAX_TAPS];
+
+    // Last 'taps' input samples per channel, oldest first
+    int16_t history1[MAX_TAPS];
+    int16_t history2[MAX_TAPS];
+
+    int position = 0;                   // Next output, in 1/up input samples
+    int warmup = 0;                     // Inputs to absorb before emitting
+
+    void design();
+    void push(int16_t s1, int16_t s2);
+    void push(int16_t s);
+
+public:
+    // Output rate = input rate * up / down. tapsPerPhase trades image and
+    // alias rejection for cost; 2 taps at 2/1 is linear interpolation.
+    bool begin(int up, int down, int tapsPerPhase);
+
+    // Clears history so the first output lines up with the first input
+    void reset();
+
+    int getUp() const { return up; }
+    int getDown() const { return down; }
+    
+    // Outputs obtainable from inputLength samples (matches process())
+    int outputLength(int inputLength) const;
+    
+    // Random access to output n of a single strided channel, identical to
+    // what process() would produce; samples outside the input read as 0
+    int16_t sampleAt(const int16_t* x, int stride, int inputLength, int n) const;
+
+    // Consumes count samples per channel and writes at most maxOut outputs
+    // per channel; returns how many were written.
+    int process(const int16_t* in1, const int16_t* in2, int count,
+                int16_t* out1, int16_t* out2, int maxOut);
+
+    // Single channel, read every stride samples so one mic of an
+    // interleaved block needs no copy; the second history is left alone
+    int process(const int16_t* in, int stride, int count, int16_t* out, int maxOut);
+};
+
+#endif
@@ -0,0 +1,38 @@
+// ============================================================================
+// SampleView.h - Read-only strided/resampled window onto a sample buffer
+// ============================================================================
+#ifndef SAMPLE_VIEW_H
+#define SAMPLE_VIEW_H
+
+#include <Arduino.h>
+#include "Resampler.h"
+
+// Stands in for a (const int16_t*, length) pair. Samples are fetched on
+// demand, so a decimated, interleaved or resampled stream needs no copy.
+struct SampleView {
+    const int16_t* data;
+    int stride;                 // Distance between consecutive input samples
+    int inputLength;            // Input samples available at data
+    int length;                 // Samples visible through the view
+    const Resampler* kernel;    // Null for a plain (strided) view
+
+    SampleView(const int16_t* data, int length, int stride = 1)
+        : data(data), stride(stride), inputLength(length), length(length), kernel(nullptr) {}
+
+    // View of data resampled by kernel's ratio, truncated to maxLength
+    static SampleView resampled(const Resampler* kernel, const int16_t* data,
+                                int inputLength, int maxLength, int stride = 1) {
+        SampleView view(data, inputLength, stride);
+        view.kernel = kernel;
+        int n = kernel->outputLength(inputLength);
+        view.length = n < maxLength ? n : maxLength;
+        return view;
+    }
+
+    int16_t operator[](int i) const {
+        if (!kernel) return data[i * stride];
+        return kernel->sampleAt(data, stride, inputLength, i);
+    }
+};
+
+#endif
@@ -0,0 +1,53 @@
+// ============================================================================
+// Scheduler.h - Cooperative one-shot/periodic timers on a pluggable clock
+// ============================================================================
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+
+class Scheduler {
+public:
+    typedef uint32_t (*ClockFn)();
+    typedef void (*TimerCallback)(void* context);
+    typedef int TimerId;
+
+    static const TimerId INVALID_TIMER = -1;
+
+private:
+    static const int MAX_TIMERS = 16;
+
+    struct Timer {
+        bool active;
+        bool periodic;
+        uint32_t due;
+        uint32_t period;
+        TimerCallback callback;
+        void* context;
+    };
+
+    Timer timers[MAX_TIMERS];
+    ClockFn clock;
+
+    static_assert(MAX_TIMERS <= 32, "tick() tracks due timers in a uint32_t");
+
+    TimerId add(uint32_t delayMs, uint32_t periodMs, bool periodic,
+                TimerCallback callback, void* context);
+
+public:
+    // Defaults to millis(); pass a virtual clock to run faster than real time
+    explicit Scheduler(ClockFn clock = nullptr);
+
+    void setClock(ClockFn clock);
+    uint32_t now() { return clock(); }
+
+    TimerId after(uint32_t delayMs, TimerCallback callback, void* context = nullptr);
+    TimerId every(uint32_t periodMs, TimerCallback callback, void* context = nullptr);
+    void cancel(TimerId id);
+    bool isPending(TimerId id);
+
+    // Run every timer that is due, earliest due first; never waits
+    void tick();
+};
+
+#endif
@@ -0,0 +1,56 @@
+// ============================================================================
+// SignalSynth.h - Reproducible test signals (DTMF, noise, laser-style capture)
+// ============================================================================
+#ifndef SIGNAL_SYNTH_H
+#define SIGNAL_SYNTH_H
+
+#include <Arduino.h>
+#include "SampleView.h"
+
+// Renders interleaved stereo frames at 16kHz, the layout the capture
+// engine delivers, so detectors can be fed exactly as in the field.
+// The noise generator is seeded: the same seed gives the same corpus.
+// Test-only: built for the native env, left out of the firmware.
+class SignalSynth {
+public:
+    struct DtmfSpec {
+        float levelDb;          // Low-group tone, dBFS
+        float twistDb;          // High-group level relative to the low group
+        float offsetPct;        // Frequency error applied to both tones
+        float snrDb;            // Tone pair power over white noise
+        int toneMs;
+        int gapMs;
+    };
+
+private:
+    uint32_t state;
+
+    float uniform();            // [-1, 1)
+    static int16_t saturate(float x);
+
+public:
+    SignalSynth(uint32_t seed = 1);
+
+    void seed(uint32_t seed);
+
+    // Gaussian-like (sum of four uniforms) noise with the given RMS
+    float gaussian(float rms);
+
+    // Keys as tone bursts on both channels; returns frames written, or 0
+    // if capacity runs out. Unknown characters render as gaps.
+    int dtmf(const char* keys, const DtmfSpec& spec, int16_t* frames, int capacity);
+
+    // Independent noise on each channel
+    void addNoise(int16_t* frames, int count, float rmsDb);
+
+    // Mono source (looped if shorter) mixed into both channels; the second
+    // mic hears it delaySamples later and scaled by mic2Gain, like sound
+    // arriving from one side. mic2Gain 0 is a laser hitting only mic 1.
+    void mix(int16_t* frames, int count, const SampleView& source, float gainDb,
+             int delaySamples = 0, float mic2Gain = 1.0f);
+
+    // dBFS <-> linear amplitude of a full-scale int16 sine
+    static float amplitude(float db);
+};
+
+#endif
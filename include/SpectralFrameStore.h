@@ -0,0 +1,54 @@
+// ============================================================================
+// SpectralFrameStore.h - Per-frame dual-mic band spectra from the wake features
+// ============================================================================
+#ifndef SPECTRAL_FRAME_STORE_H
+#define SPECTRAL_FRAME_STORE_H
+
+#include <Arduino.h>
+#include "AudioProcessor.h"
+
+// The feature front end adds one frame per MFCC frame it computes, so the
+// store slides along with the wake-word window. Frames are numbered from
+// the first one ever added; a reader publishes the window it cares about
+// by the number of its first frame.
+class SpectralFrameStore {
+public:
+    static const int BANDS = 8;
+    static const int BINS_PER_BAND = (FFT_BINS - 1) / BANDS;  // DC bin skipped
+
+    // The scored window plus as much again of newer frames, so scoring can
+    // fall a hop or so behind the features
+    static const int CAPACITY = 2 * N_FRAMES;
+
+    struct Frame {
+        float energy1[BANDS];   // Mic 1 band power
+        float energy2[BANDS];   // Mic 2 band power
+        float crossRe[BANDS];   // Band sum of X1 * conj(X2)
+        float crossIm[BANDS];
+    };
+
+private:
+    Frame frames[CAPACITY];
+    uint32_t written = 0;       // Frames ever added
+    int next = 0;               // Slot the next frame goes to
+    int firstSlot = 0;          // Published window
+    int frameCount = 0;
+    uint32_t generation = 0;
+
+public:
+    // Called by the feature front end for each new frame, zeroed
+    Frame* add();
+    uint32_t getWritten() const { return written; }
+
+    // Selects the N_FRAMES window starting at frame first. False, with no
+    // frames, once newer ones have overwritten part of it.
+    bool publish(uint32_t first);
+
+    int getFrameCount() const { return frameCount; }
+    const Frame& getFrame(int i) const { return frames[(firstSlot + i) % CAPACITY]; }
+
+    // Bumped on every publish so readers can tell fresh spectra from stale
+    uint32_t getGeneration() const { return generation; }
+};
+
+#endif
@@ -0,0 +1,37 @@
+// ============================================================================
+// StateMachine.h - Explicit state objects with enter/tick/exit hooks
+// ============================================================================
+#ifndef STATE_MACHINE_H
+#define STATE_MACHINE_H
+
+class State {
+public:
+    virtual ~State() {}
+
+    virtual const char* name() = 0;
+    virtual void enter() {}
+    virtual void tick() = 0;   // Must return promptly; wait with timers, not delay()
+    virtual void exit() {}
+};
+
+class StateMachine {
+private:
+    static const int MAX_CHAINED_TRANSITIONS = 4;
+
+    State* current;
+    State* pending;
+
+    void applyPending();
+
+public:
+    StateMachine();
+
+    // Takes effect before the next tick, so it is safe to call from enter()/tick()
+    void transitionTo(State* next);
+    void tick();
+
+    State* getCurrent() { return current; }
+    bool isIn(State* state) { return current == state; }
+};
+
+#endif
@@ -0,0 +1,85 @@
+// ============================================================================
+// StreamingCnn.h - Wake-word CNN forward pass with per-layer column caches
+// ============================================================================
+#ifndef STREAMING_CNN_H
+#define STREAMING_CNN_H
+
+#include <Arduino.h>
+#include "AudioProcessor.h"
+
+namespace tflite {
+    struct Model;
+}
+
+class WorkerPool;
+
+// The wake-word model is a temporal CNN: three SAME-padded ReLU convs with
+// a 2x pool after the first two, a global mean and two dense layers. When
+// the MFCC window slides by whole frames, every layer's output slides with
+// it, so this keeps each layer's activations and recomputes only the time
+// rows that see new frames or sit within a kernel of the window edges
+// (where SAME padding differs). Weights are copied out of the .tflite
+// flatbuffer; begin() refuses any other topology. With a pool, each conv
+// layer's stale rows are handed out one per item.
+class StreamingCnn {
+public:
+    static const int DECIMATION = 4;    // Time stride of the pools; hops must be a multiple
+
+private:
+    static const int KW = 3;            // Every kernel is 3 MFCC bins wide
+    static const int K1 = 7, K2 = 5, K3 = 3;
+    static const int C1 = 3, C2 = 6, C3 = 10;
+    static const int DENSE = 10;
+    static const int T1 = N_FRAMES, T2 = T1 / 2, T3 = T2 / 2;
+    static const int W1 = N_MFCC, W3 = W1 / 2;
+
+    // Filters as stored by TFLite: [out][row][column][in]
+    float w1[C1 * K1 * KW * 1];
+    float b1[C1];
+    float w2[C2 * K2 * KW * C1];
+    float b2[C2];
+    float w3[C3 * K3 * KW * C2];
+    float b3[C3];
+    float fc1[DENSE * C3];
+    float fcb1[DENSE];
+    float fc2[DENSE];
+    float fcb2;
+
+    // Cached activations, [row][column][channel]
+    float conv1[T1 * W1 * C1];
+    float pool1[T2 * W1 * C1];
+    float conv2[T2 * W1 * C2];
+    float pool2[T3 * W3 * C2];
+    float conv3[T3 * W3 * C3];
+
+    WorkerPool* workers = nullptr;
+    bool ready = false;
+    bool primed = false;
+    uint32_t fullMacs = 0;
+    uint32_t lastMacs = 0;
+
+    uint32_t conv(const float* in, int rows, int width, int inC, const float* weights,
+                  const float* bias, int kh, int outC, float* out, int lo, int hi, bool full);
+
+public:
+    // Binds to the model's weights; false if its layers are not the ones above
+    bool begin(const tflite::Model* model);
+    bool isReady() const { return ready; }
+
+    // Next pass recomputes every row
+    void invalidate() { primed = false; }
+
+    // Splits the conv rows across pool from now on; null runs them serially
+    void setWorkers(WorkerPool* pool) { workers = pool; }
+
+    // Scores an N_FRAMES x N_MFCC window whose last newFrames rows are new
+    // since the previous call; anything not a multiple of DECIMATION, or a
+    // first call, runs the full pass
+    float predict(const float* features, int newFrames);
+
+    // Multiply-accumulates in the last pass and in a full one
+    uint32_t getLastMacs() const { return lastMacs; }
+    uint32_t getFullMacs() const { return fullMacs; }
+};
+
+#endif
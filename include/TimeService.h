@@ -0,0 +1,91 @@
+// ============================================================================
+// TimeService.h - Monotonic wall clock disciplined by non-blocking SNTP
+// ============================================================================
+#ifndef TIME_SERVICE_H
+#define TIME_SERVICE_H
+
+#include <Arduino.h>
+#include <WiFiUdp.h>
+#include "lwip/dns.h"
+
+// NTP Settings
+#define NTP_SERVER "pool.ntp.org"
+#define UTC_OFFSET_SEC -18000
+// EST = -18000, PST = -28800, CET = 3600
+
+class TimeService {
+private:
+    static const int NTP_PACKET_SIZE = 48;
+    static const uint16_t NTP_PORT = 123;
+    static const uint16_t LOCAL_PORT = 2390;
+    static const uint32_t NTP_UNIX_OFFSET = 2208988800UL; // 1900 -> 1970
+
+    static const unsigned long DNS_TIMEOUT = 5000;
+    static const unsigned long REPLY_TIMEOUT = 2000;
+    static const unsigned long RETRY_INTERVAL = 10000;
+    static const unsigned long MIN_POLL_INTERVAL = 64000;     // Until drift settles
+    static const unsigned long MAX_POLL_INTERVAL = 3600000;   // Sync every hour at most
+
+    static const int64_t STEP_THRESHOLD_US = 1000000;  // Larger errors are stepped
+    static const int32_t MAX_SLEW_PPM = 500;           // Smaller ones are slewed
+    static const int32_t MAX_DRIFT_PPB = 500000;
+
+    enum DnsState { DNS_IDLE, DNS_PENDING, DNS_RESOLVED, DNS_FAILED };
+
+    WiFiUDP udp;
+    const char* server;
+    IPAddress serverIP;
+    bool serverResolved;
+    bool udpStarted;
+
+    // Asynchronous lookup; the callback runs on the lwIP task
+    volatile uint8_t dnsState;
+    volatile uint32_t dnsAddress;
+    unsigned long dnsStart;
+    long utcOffsetSec;
+
+    // Clock model: epoch(t) = anchorEpochUs + (t - anchorMonoUs) * (1 + driftPpb/1e9) + slew
+    int64_t anchorMonoUs;
+    int64_t anchorEpochUs;
+    int32_t driftPpb;
+    int64_t pendingSlewUs;
+    bool timeSet;
+    portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;  // Clock is read from the UI task
+    int syncCount;
+
+    // Outstanding request
+    bool awaitingReply;
+    int64_t requestMonoUs;
+    unsigned long nextSyncAt;
+    unsigned long pollInterval;
+    bool syncRequested;
+
+    static void onDnsFound(const char* name, const ip_addr_t* address, void* context);
+    bool resolveServer();
+
+    static int64_t monotonicUs();
+    int64_t epochUsAt(int64_t monoUs);
+    int64_t nowUs();
+
+    bool sendRequest();
+    void receiveReply();
+    void discipline(int64_t measuredEpochUs, int64_t monoUs);
+
+public:
+    TimeService();
+
+    void begin(const char* server = NTP_SERVER, long utcOffsetSec = UTC_OFFSET_SEC);
+    void loop();
+    void requestSync() { syncRequested = true; }
+
+    // O(1), never touches the network
+    bool isTimeSet() { return timeSet; }
+    uint32_t now();        // Local time, seconds since 1970
+
+    // Local calendar fields (day: 0 = Sunday)
+    void getLocalTime(int& hours, int& minutes, int& seconds, int& day);
+
+    int32_t getDriftPpb() { return driftPpb; }
+};
+
+#endif
@@ -0,0 +1,80 @@
+// ============================================================================
+// UiService.h - LCD rendering task fed by a message queue
+// ============================================================================
+#ifndef UI_SERVICE_H
+#define UI_SERVICE_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "LcdTimeDisplay.h"
+#include "TimeService.h"
+
+// Owns the LCD. Callers post status/toast messages and return immediately;
+// a FreeRTOS task on the other core renders them, so audio capture and
+// inference never wait on the display.
+class UiService {
+public:
+    enum Priority : uint8_t {
+        PRIORITY_LOW = 0,
+        PRIORITY_NORMAL = 1,
+        PRIORITY_ALERT = 2
+    };
+
+private:
+    enum MessageType : uint8_t {
+        MSG_STATUS,     // Persistent status line
+        MSG_TOAST       // Shown for durationMs, then the status line returns
+    };
+
+    struct Message {
+        MessageType type;
+        uint8_t priority;
+        uint16_t durationMs;
+        char text[LCD_COLS + 1];
+    };
+
+    static const int QUEUE_LENGTH = 16;
+    static const int MAX_PENDING_TOASTS = 8;
+    static const uint32_t TASK_STACK_SIZE = 4096;
+    static const unsigned long MAX_IDLE_WAIT_MS = 200;  // Keeps the clock ticking
+
+    LcdTimeDisplay* display;
+    QueueHandle_t queue;
+    TaskHandle_t task;
+
+    // Caller side: skip re-posting an unchanged status every loop(). Callers
+    // run on both cores, so the compare-and-post is one step under the lock.
+    SemaphoreHandle_t statusLock;
+    char lastPostedStatus[LCD_COLS + 1];
+    std::atomic<unsigned long> droppedMessages;
+
+    // Task side
+    char statusText[LCD_COLS + 1];
+    Message activeToast;
+    bool toastActive;
+    unsigned long toastExpiresAt;
+    Message pendingToasts[MAX_PENDING_TOASTS];
+    int pendingCount;
+
+    static void taskEntry(void* param);
+    void run();
+    void handleMessage(const Message& msg);
+    void showToast(const Message& msg);
+    void requeueActiveToast();
+    void expireToast();
+    bool post(MessageType type, const char* text, uint16_t durationMs, uint8_t priority);
+
+public:
+    UiService();
+
+    void begin(TimeService* clockSource);
+
+    // Never wait on the display; messages are dropped (and counted) if the
+    // queue is full. Safe to call from any task.
+    void status(const char* text);
+    void toast(const char* text, uint16_t durationMs, uint8_t priority = PRIORITY_NORMAL);
+
+    unsigned long getDroppedMessages() { return droppedMessages; }
+};
+
+#endif
@@ -6,19 +6,43 @@
 
 #include "NeuralNetwork.h"
 #include "AudioProcessor.h"
+#include "SpectralFrameStore.h"
 
 class VoiceDetector {
 private:
     NeuralNetwork* nn;
     AudioProcessor* audioProcessor;
     float mfcc_features[N_FRAMES][N_MFCC];
+    SpectralFrameStore spectra;
+    bool featuresValid = false; // mfcc_features hold the last scored window
     
 public:
     VoiceDetector();
     ~VoiceDetector();
     
-    // Process int16_t audio (matches ESP32 mic format)
-    float detectWakeWord(const int16_t* audio, int length);
+    // Process int16_t audio (matches ESP32 mic format). advance is how far
+    // the window moved since the last call, in samples of audio; the MFCC
+    // frames and CNN columns it still covers are reused. Negative, or not
+    // a whole number of frames, scores the window from scratch.
+    float detectWakeWord(const SampleView& audio, int advance = -1);
+    
+    // The two halves of detectWakeWord(), for callers that run them on
+    // different cores: extractFeatures() returns the frames it computed,
+    // scoreFeatures() takes an N_FRAMES x N_MFCC window and its new rows.
+    // Given the raw mic pair as well, the new frames' band spectra go to
+    // the store for the laser checks.
+    int extractFeatures(const SampleView& audio, int advance = -1,
+                        const SampleView* mic1 = nullptr, const SampleView* mic2 = nullptr);
+    const float* getFeatures() const { return &mfcc_features[0][0]; }
+    float scoreFeatures(const float* features, int newFrames);
+    
+    // Store frame number of the first row of the window extractFeatures()
+    // last built with the mic pair; publishSpectra() hands that window's
+    // spectra to the laser checks, false if it has been overwritten
+    uint32_t getSpectraStart() const { return spectra.getWritten() - N_FRAMES; }
+    bool publishSpectra(uint32_t firstFrame) { return spectra.publish(firstFrame); }
+    
+    const SpectralFrameStore* getSpectra() { return &spectra; }
     
     // Helper to print MFCC features for debugging
     void printMFCC(int frame);
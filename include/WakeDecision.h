@@ -0,0 +1,61 @@
+// ============================================================================
+// WakeDecision.h - Wake-word trigger logic over a stream of window scores
+// ============================================================================
+#ifndef WAKE_DECISION_H
+#define WAKE_DECISION_H
+
+#include <Arduino.h>
+
+// Consecutive wake-word windows overlap, so a spoken wake word scores high
+// in more than one of them while a noise spike usually hits just one.
+// Each score is averaged with the ones before it, the trigger needs k of
+// the last n averages above the mode's threshold, and after a trigger the
+// engine stays quiet for a refractory period. The peak average over the
+// last n windows is held for logging.
+class WakeDecision {
+public:
+    static const int MAX_WINDOWS = 8;
+
+    struct Mode {
+        const char* name;
+        float threshold;
+        uint8_t smoothing;          // Scores per moving average, 1 = raw
+        uint8_t required;           // k
+        uint8_t windows;            // n
+        uint32_t refractoryMs;
+    };
+
+    static const Mode STRICT;       // Defence on
+    static const Mode RELAXED;      // Defence off
+
+private:
+    const Mode* mode;
+    float scores[MAX_WINDOWS];      // Raw scores, ring
+    float averages[MAX_WINDOWS];    // Moving averages, ring
+    int head = 0;                   // Next slot
+    int count = 0;                  // Valid entries
+    float average = 0.0f;
+    float peak = 0.0f;
+    int hits = 0;
+    uint32_t refractoryStart = 0;
+    bool refractory = false;
+
+public:
+    WakeDecision(const Mode& mode = STRICT);
+
+    // Switching modes forgets the history
+    void setMode(const Mode& mode);
+    const Mode& getMode() const { return *mode; }
+
+    void reset();
+
+    // Adds one window's score; true when it completes a trigger
+    bool update(float score, uint32_t nowMs);
+
+    float getAverage() const { return average; }
+    float getPeak() const { return peak; }
+    int getHits() const { return hits; }
+    bool isRefractory() const { return refractory; }
+};
+
+#endif
@@ -0,0 +1,89 @@
+// ============================================================================
+// WakePipeline.h - Wake-word capture/features on core 0, scoring on core 1
+// ============================================================================
+#ifndef WAKE_PIPELINE_H
+#define WAKE_PIPELINE_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "AudioProcessor.h"
+
+// A task pinned to core 0 records the sliding wake-word window and turns
+// each hop into MFCC frames; finished windows travel through a short queue
+// to loop() on core 1, which runs the model and the trigger logic. The
+// ADC samples by DMA meanwhile, so the features never leave a gap in the
+// audio as long as they fit the capture pool. The capture never waits for
+// inference: when the queue is full the window is
+// dropped and counted, and the next one that gets through carries a full
+// frame count so the model's column cache starts over.
+class WakePipeline {
+public:
+    struct Window {
+        float features[N_FRAMES][N_MFCC];
+        int newFrames;              // Rows not in the previous queued window
+        uint32_t spectraStart;      // Row 0 in the detector's spectra store
+        uint32_t featureMicros;     // Source time spent on the features
+        uint32_t sequence;
+        uint32_t readyAt;           // millis() when the features were done
+    };
+
+    // Records one capture chunk on the pipeline task; once a window is
+    // finished, fills its features, newFrames (rows new since the source's
+    // previous window), spectraStart and featureMicros and returns true
+    typedef bool (*Source)(Window& window, void* context);
+
+    struct Stats {
+        uint32_t produced;
+        uint32_t dropped;
+        uint32_t consumed;
+        uint8_t maxDepth;           // Deepest the queue got
+        uint32_t maxLatencyMs;      // Features done to scoring started
+        uint32_t maxFeatureMicros;
+    };
+
+private:
+    static const int QUEUE_LENGTH = 2;
+    static const uint32_t TASK_STACK_SIZE = 8192;
+
+    Source source = nullptr;
+    void* sourceContext = nullptr;
+    QueueHandle_t queue = nullptr;
+    TaskHandle_t task = nullptr;
+
+    // Handshake: the task parks itself (idle) whenever it sees !active
+    std::atomic<bool> active{false};
+    std::atomic<bool> idle{true};
+
+    // Task side
+    Window staging;
+    uint32_t sequence = 0;
+    bool resync = true;
+
+    // loop() side
+    Window current;
+
+    Stats stats;
+
+    static void taskEntry(void* param);
+    void run();
+    void produce();
+
+public:
+    void begin(Source source, void* context);
+
+    // Start and stop the capture task; stop() returns once it is parked,
+    // after which the capture buffers are loop()'s again
+    void start();
+    void stop();
+    bool isActive() const { return active; }
+
+    // Oldest finished window, or null if none is waiting. Valid until the
+    // next call.
+    const Window* poll();
+
+    const Stats& getStats() const { return stats; }
+    void resetStats();
+    void printStats(const char* label);
+};
+
+#endif
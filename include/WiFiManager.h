@@ -0,0 +1,86 @@
+// ============================================================================
+// WiFiManager.h - Event-driven WiFi connection with cached AP fast-connect
+// ============================================================================
+#ifndef WIFI_MANAGER_H
+#define WIFI_MANAGER_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <Preferences.h>
+
+class WiFiManager {
+public:
+    enum State {
+        WIFI_IDLE,
+        WIFI_FAST_CONNECTING,   // Direct join using cached BSSID/channel (DHCP)
+        WIFI_SCANNING,          // Async scan, only after a fast-connect failure
+        WIFI_CONNECTING,        // Join after scan (DHCP)
+        WIFI_CONNECTED,
+        WIFI_BACKOFF            // Waiting before the next attempt
+    };
+
+private:
+    // Last good association, persisted in NVS. The address is not cached:
+    // a lease can expire while the device is off, so DHCP always runs.
+    struct CachedAp {
+        uint32_t magic;
+        uint8_t bssid[6];
+        uint8_t channel;
+    };
+    static const uint32_t CACHE_MAGIC = 0x57494632; // "WIF2"
+
+    // Join plus a DHCP exchange
+    static const unsigned long FAST_CONNECT_TIMEOUT = 3000;
+    static const unsigned long CONNECT_TIMEOUT = 10000;
+    static const unsigned long RETRY_BACKOFF = 5000;
+
+    static WiFiManager* instance;
+
+    const char* ssid;
+    const char* password;
+    Preferences prefs;
+    CachedAp cache;
+    bool cacheValid;
+
+    State state;
+    unsigned long stateStart;
+    unsigned long connectStart;
+    unsigned long lastConnectDuration;
+
+    // Set from the WiFi event task, consumed in loop()
+    volatile bool gotIpEvent;
+    volatile bool disconnectEvent;
+    volatile uint8_t disconnectReason;
+
+    bool connectedEdge;
+    bool disconnectedEdge;
+
+    static void onWiFiEvent(WiFiEvent_t event, WiFiEventInfo_t info);
+
+    bool loadCache();
+    void saveCache();
+    void clearCache();
+
+    void enterState(State newState);
+    void startFastConnect();
+    void startScan();
+    void startConnect(const uint8_t* bssid, int32_t channel);
+    void handleScanResult();
+    void handleConnected();
+
+public:
+    WiFiManager();
+
+    void begin(const char* ssid, const char* password);
+    void loop();
+
+    bool isConnected() { return state == WIFI_CONNECTED; }
+    bool justConnected();
+    bool justDisconnected();
+
+    State getState() { return state; }
+    bool isAttemptFinished() { return state == WIFI_CONNECTED || state == WIFI_BACKOFF; }
+    unsigned long getLastConnectDuration() { return lastConnectDuration; }
+};
+
+#endif
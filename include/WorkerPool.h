@@ -0,0 +1,79 @@
+// ============================================================================
+// WorkerPool.h - Splits a loop across the caller and helper tasks
+// ============================================================================
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <Arduino.h>
+#include <atomic>
+
+// One per spare core on the ESP32-S3; host builds raise it to try more
+#ifndef WORKER_POOL_MAX_HELPERS
+#define WORKER_POOL_MAX_HELPERS 1
+#endif
+
+// run() hands out the items of a job one at a time from a shared counter;
+// the calling task works through them alongside its helpers, so a helper
+// that the scheduler has not woken yet only means the caller does more of
+// the work. Each item is done start to finish by one task, which keeps
+// results identical to a serial loop as long as items write disjoint
+// outputs. The barrier at the end cancels helpers that never started and
+// sleeps until the ones mid-item notify it, so a low-priority helper that
+// gets preempted never has the caller spinning on it.
+class WorkerPool {
+public:
+    typedef void (*Job)(void* context, int item);
+
+    static const int MAX_HELPERS = WORKER_POOL_MAX_HELPERS;
+
+    struct Stats {
+        uint32_t runs;
+        uint32_t items;
+        uint32_t helperItems;           // Of those, done by a helper
+    };
+
+private:
+    static const uint32_t TASK_STACK_SIZE = 4096;
+
+    enum HelperState { HELPER_IDLE, HELPER_PENDING, HELPER_RUNNING, HELPER_JOINING };
+
+    struct Helper {
+        WorkerPool* pool;
+        TaskHandle_t task;
+        std::atomic<int> state;
+    };
+
+    Helper helpers[MAX_HELPERS];
+    int helperCount = 0;
+
+    // Current job; written only while every helper is idle
+    Job job = nullptr;
+    void* context = nullptr;
+    int count = 0;
+    std::atomic<int> next;
+    TaskHandle_t caller = nullptr;      // Task inside run(), woken by joined helpers
+
+    Stats stats;
+
+    static void helperEntry(void* param);
+    int work();
+
+public:
+    WorkerPool();
+    ~WorkerPool();
+
+    // Starts up to MAX_HELPERS helper tasks pinned to core at priority;
+    // false if none could be created (run() then stays serial)
+    bool begin(int helpers, int core, int priority);
+
+    int getWorkers() const { return helperCount + 1; }
+
+    // Calls job(context, item) for every item in [0, count), returning when
+    // all of them are done. Not reentrant.
+    void run(Job job, void* context, int count);
+
+    const Stats& getStats() const { return stats; }
+    void resetStats();
+};
+
+#endif
@@ -3,8 +3,12 @@
 // ============================================================================
 #ifndef MAIN_H
 #define MAIN_H
-#include "LcdTimeDisplay.h"
+#include "UiService.h"
+#include "TimeService.h"
+#include "LaserAttackDetector.h"
 
-extern LcdTimeDisplay* lcdDisplay;
+extern UiService* ui;
+extern TimeService* timeService;
+extern LaserAttackDetector* laserDetector;
 extern bool defenceSet;
 #endif
\ No newline at end of file
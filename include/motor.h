@@ -10,6 +10,8 @@
 void MOTOR_setup();
 void handleMorningCommand();
 void handleNightCommand();
+void MOTOR_tick();
+bool MOTOR_isBusy();
 
 
 
@@ -149,9 +149,12 @@ class MicroMutableOpResolver : public MicroOpResolver {
                       ParseConcatenation);
   }
 
-  TfLiteStatus AddConv2D() {
-    return AddBuiltin(BuiltinOperator_CONV_2D,
-                      tflite::ops::micro::Register_CONV_2D(), ParseConv2D);
+  // Takes an optional registration so that an application can substitute its
+  // own kernel for the reference one.
+  TfLiteStatus AddConv2D(
+      const TfLiteRegistration& registration =
+          tflite::ops::micro::Register_CONV_2D()) {
+    return AddBuiltin(BuiltinOperator_CONV_2D, registration, ParseConv2D);
   }
 
   TfLiteStatus AddCos() {
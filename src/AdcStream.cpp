@@ -0,0 +1,120 @@
+// ============================================================================
+// AdcStream.cpp - Continuous DMA capture of the mic pins
+// ============================================================================
+#include "AdcStream.h"
+
+bool AdcStream::begin(const int* pins, int count, uint32_t frameRate, uint32_t poolFrames) {
+    if (running || count < 1 || count > MAX_CHANNELS) return false;
+
+    adc_digi_pattern_config_t pattern[MAX_CHANNELS];
+    uint32_t mask = 0;
+    for (int i = 0; i < count; i++) {
+        int channel = digitalPinToAnalogChannel(pins[i]);
+        if (channel < 0 || channel > 9) return false;   // ADC1 only; ADC2 is WiFi's
+
+        channels[i] = channel;
+        mask |= 1 << channel;
+        pattern[i].atten = ADC_ATTEN_DB_11;
+        pattern[i].channel = channel;
+        pattern[i].unit = 0;
+        pattern[i].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+        partial[i] = 2048;      // Mid-scale until the first frame
+    }
+    channelCount = count;
+
+    adc_digi_init_config_t init = {};
+    init.max_store_buf_size = poolFrames * count * CONVERSION_BYTES;
+    init.conv_num_each_intr = BLOCK_CONVERSIONS * CONVERSION_BYTES;
+    init.adc1_chan_mask = mask;
+    init.adc2_chan_mask = 0;
+    if (adc_digi_initialize(&init) != ESP_OK) return false;
+
+    // One conversion per pin per frame
+    adc_digi_configuration_t config = {};
+    config.conv_limit_en = false;
+    config.conv_limit_num = 250;
+    config.pattern_num = count;
+    config.adc_pattern = pattern;
+    config.sample_freq_hz = frameRate * count;
+    config.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    config.format = ADC_DIGI_OUTPUT_FORMAT_TYPE2;
+    if (adc_digi_controller_configure(&config) != ESP_OK || adc_digi_start() != ESP_OK) {
+        adc_digi_deinitialize();
+        return false;
+    }
+
+    running = true;
+    drain();
+    overruns = 0;
+    stalls = 0;
+    return true;
+}
+
+void AdcStream::end() {
+    if (!running) return;
+    adc_digi_stop();
+    adc_digi_deinitialize();
+    running = false;
+}
+
+bool AdcStream::fill(uint32_t timeoutMs) {
+    uint32_t length = 0;
+    esp_err_t result = adc_digi_read_bytes(block, sizeof(block), &length, timeoutMs);
+
+    // The pool overflowed before this read; the readings are still good
+    if (result == ESP_ERR_INVALID_STATE) {
+        overruns++;
+    } else if (result != ESP_OK) {
+        length = 0;
+    }
+
+    blockLength = length - length % CONVERSION_BYTES;
+    blockIndex = 0;
+    return blockLength > 0;
+}
+
+bool AdcStream::read(uint16_t* raw, int count) {
+    int frames = 0;
+    while (running && frames < count) {
+        if (blockIndex >= blockLength && !fill(READ_TIMEOUT_MS)) break;
+
+        adc_digi_output_data_t conversion;
+        memcpy(&conversion, block + blockIndex, CONVERSION_BYTES);
+        blockIndex += CONVERSION_BYTES;
+
+        // Slots arrive in pattern order; after a dropped conversion, wait
+        // for the first pin again so the pair stays a pair
+        int slot = partialCount;
+        if (conversion.type2.channel != channels[slot]) {
+            partialCount = 0;
+            if (conversion.type2.channel != channels[0]) continue;
+            slot = 0;
+        }
+        partial[slot] = conversion.type2.data;
+        if (++partialCount < channelCount) continue;
+
+        memcpy(raw + frames * channelCount, partial, channelCount * sizeof(uint16_t));
+        partialCount = 0;
+        frames++;
+    }
+    if (frames == count) return true;
+
+    // Keep the consumers' timing: hold the last reading over the gap
+    stalls++;
+    for (; frames < count; frames++) {
+        for (int c = 0; c < channelCount; c++) raw[frames * channelCount + c] = partial[c];
+    }
+    return false;
+}
+
+void AdcStream::drain() {
+    if (!running) return;
+
+    // A pool nobody read while idle has overflowed; that is not an overrun
+    uint32_t kept = overruns;
+    while (fill(0)) {}
+    overruns = kept;
+    blockLength = 0;
+    blockIndex = 0;
+    partialCount = 0;
+}
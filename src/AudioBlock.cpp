@@ -0,0 +1,104 @@
+// ============================================================================
+// AudioBlock.cpp - Interleaved multi-channel sample block + layout kernels
+// ============================================================================
+#include "AudioBlock.h"
+#include "utils.h"
+
+bool AudioBlock::allocate(int channels, int capacity, const char* name) {
+    release(name);
+
+    frames = (int16_t*)allocateAudioBuffer((size_t)channels * capacity, name);
+    if (!frames) return false;
+
+    this->channels = channels;
+    this->capacity = capacity;
+    length = 0;
+    return true;
+}
+
+void AudioBlock::release(const char* name) {
+    freeAudioBuffer(frames, name);
+    frames = nullptr;
+    channels = 0;
+    capacity = 0;
+    length = 0;
+}
+
+void AudioBlock::commit(int count) {
+    length += count;
+    if (length > capacity) length = capacity;
+}
+
+void AudioBlock::discard(int count) {
+    if (count >= length) {
+        length = 0;
+        return;
+    }
+    length -= count;
+    memmove(frames, &frames[count * channels], (size_t)length * channels * sizeof(int16_t));
+}
+
+int AudioBlock::appendInterleaved(const int16_t* in, int count) {
+    if (count > capacity - length) count = capacity - length;
+    memcpy(&frames[length * channels], in, (size_t)count * channels * sizeof(int16_t));
+    length += count;
+    return count;
+}
+
+int AudioBlock::appendPlanar(const int16_t* ch0, const int16_t* ch1, int count) {
+    if (channels != 2) return 0;
+    if (count > capacity - length) count = capacity - length;
+    interleave2(ch0, ch1, &frames[length * 2], count);
+    length += count;
+    return count;
+}
+
+void AudioBlock::copyChannels(int start, int count, int16_t* ch0, int16_t* ch1) const {
+    if (channels != 2) return;
+    deinterleave2(&frames[start * 2], ch0, ch1, count);
+}
+
+// A stereo frame is one 32-bit word (ch0 in the low half on this
+// little-endian target), so each frame moves with a single load/store
+static inline uint32_t loadFrame(const int16_t* p) {
+    uint32_t w;
+    memcpy(&w, p, sizeof(w));
+    return w;
+}
+
+static inline void storeFrame(int16_t* p, int16_t a, int16_t b) {
+    uint32_t w = (uint16_t)a | ((uint32_t)(uint16_t)b << 16);
+    memcpy(p, &w, sizeof(w));
+}
+
+void AudioBlock::deinterleave2(const int16_t* in, int16_t* ch0, int16_t* ch1, int count) {
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        uint32_t w0 = loadFrame(&in[2 * i]);
+        uint32_t w1 = loadFrame(&in[2 * i + 2]);
+        uint32_t w2 = loadFrame(&in[2 * i + 4]);
+        uint32_t w3 = loadFrame(&in[2 * i + 6]);
+        ch0[i]     = (int16_t)w0;  ch1[i]     = (int16_t)(w0 >> 16);
+        ch0[i + 1] = (int16_t)w1;  ch1[i + 1] = (int16_t)(w1 >> 16);
+        ch0[i + 2] = (int16_t)w2;  ch1[i + 2] = (int16_t)(w2 >> 16);
+        ch0[i + 3] = (int16_t)w3;  ch1[i + 3] = (int16_t)(w3 >> 16);
+    }
+    for (; i < count; i++) {
+        ch0[i] = in[2 * i];
+        ch1[i] = in[2 * i + 1];
+    }
+}
+
+void AudioBlock::interleave2(const int16_t* ch0, const int16_t* ch1, int16_t* out, int count) {
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        storeFrame(&out[2 * i],     ch0[i],     ch1[i]);
+        storeFrame(&out[2 * i + 2], ch0[i + 1], ch1[i + 1]);
+        storeFrame(&out[2 * i + 4], ch0[i + 2], ch1[i + 2]);
+        storeFrame(&out[2 * i + 6], ch0[i + 3], ch1[i + 3]);
+    }
+    for (; i < count; i++) {
+        out[2 * i]     = ch0[i];
+        out[2 * i + 1] = ch1[i];
+    }
+}
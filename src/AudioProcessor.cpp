@@ -2,6 +2,19 @@
 // AudioProcessor.cpp - Process int16_t audio
 // ============================================================================
 #include "AudioProcessor.h"
+#include "SpectralFrameStore.h"
+
+float AudioProcessor::twiddle_cos[N_FFT / 2];
+float AudioProcessor::twiddle_sin[N_FFT / 2];
+bool AudioProcessor::twiddles_ready = false;
+
+void AudioProcessor::initTwiddles() {
+    for (int k = 0; k < N_FFT / 2; k++) {
+        twiddle_cos[k] = cos(-2.0 * PI * k / N_FFT);
+        twiddle_sin[k] = sin(-2.0 * PI * k / N_FFT);
+    }
+    twiddles_ready = true;
+}
 
 AudioProcessor::AudioProcessor() {
     // Initialize Hanning window
@@ -12,6 +25,8 @@ AudioProcessor::AudioProcessor() {
 
 // Simplified FFT for N=256 (power of 2)
 void AudioProcessor::computeFFT(float* real, float* imag, int n) {
+    if (!twiddles_ready) initTwiddles();
+    
     // Bit-reversal permutation
     int j = 0;
     for (int i = 0; i < n - 1; i++) {
@@ -33,11 +48,12 @@ void AudioProcessor::computeFFT(float* real, float* imag, int n) {
     
     // Cooley-Tukey FFT
     for (int len = 2; len <= n; len *= 2) {
-        float angle = -2.0 * PI / len;
+        // exp(-2*pi*i*k/len) is entry k * (N_FFT/len) of the N_FFT table
+        int step = N_FFT / len;
         for (int i = 0; i < n; i += len) {
             for (int k = 0; k < len / 2; k++) {
-                float cos_val = cos(angle * k);
-                float sin_val = sin(angle * k);
+                float cos_val = twiddle_cos[k * step];
+                float sin_val = twiddle_sin[k * step];
                 
                 int idx1 = i + k;
                 int idx2 = i + k + len / 2;
@@ -55,11 +71,25 @@ void AudioProcessor::computeFFT(float* real, float* imag, int n) {
 }
 
 // Extract MFCC from int16_t audio (matching ESP32 mic format)
-void AudioProcessor::extractMFCC(const int16_t* audio, int length, float mfcc_features[][N_MFCC]) {
+void AudioProcessor::extractMFCC(const SampleView& audio, float mfcc_features[][N_MFCC]) {
+    extractFrames(audio, mfcc_features, 0, nullptr, nullptr, nullptr);
+}
+
+void AudioProcessor::extractMFCCFrom(const SampleView& audio, float mfcc_features[][N_MFCC],
+                                     int firstFrame, const SampleView* mic1,
+                                     const SampleView* mic2, SpectralFrameStore* store) {
+    extractFrames(audio, mfcc_features, firstFrame, mic1, mic2, store);
+}
+
+void AudioProcessor::extractFrames(const SampleView& audio, float mfcc_features[][N_MFCC],
+                                   int firstFrame, const SampleView* mic1,
+                                   const SampleView* mic2, SpectralFrameStore* store) {
+    int length = audio.length;
+    
     // Process each frame
-    int frame_idx = 0;
+    int frame_idx = firstFrame;
     
-    for (int start = 0; start + N_FFT <= length && frame_idx < N_FRAMES; start += HOP_LENGTH) {
+    for (int start = firstFrame * HOP_LENGTH; start + N_FFT <= length && frame_idx < N_FRAMES; start += HOP_LENGTH) {
         // Apply window and convert int16_t to float
         // Note: We keep the int16_t scale here (no division by 32768)
         for (int i = 0; i < N_FFT; i++) {
@@ -103,6 +133,39 @@ void AudioProcessor::extractMFCC(const int16_t* audio, int length, float mfcc_fe
             mfcc_features[frame_idx][mfcc] *= sqrt(2.0 / MEL_BINS);
         }
         
+        if (store) addSpectra(mic1, mic2, start, store);
+        
         frame_idx++;
     }
-}
\ No newline at end of file
+}
+
+// One store frame per MFCC frame, left zero when the pair does not reach
+// this far, so frame numbers stay in step with the window
+void AudioProcessor::addSpectra(const SampleView* mic1, const SampleView* mic2, int start,
+                                SpectralFrameStore* store) {
+    SpectralFrameStore::Frame* frame = store->add();
+    if (!mic1 || !mic2 || start + N_FFT > mic1->length || start + N_FFT > mic2->length) return;
+    
+    for (int i = 0; i < N_FFT; i++) {
+        fft_real[i] = (float)(*mic1)[start + i] * hanning_window[i];
+        fft_imag[i] = (float)(*mic2)[start + i] * hanning_window[i];
+    }
+    computeFFT(fft_real, fft_imag, N_FFT);
+    
+    // Mic 2 rode in the imaginary part; split by conjugate symmetry
+    for (int i = 1; i < FFT_BINS; i++) {
+        int band = (i - 1) / SpectralFrameStore::BINS_PER_BAND;
+        if (band >= SpectralFrameStore::BANDS) break;
+        
+        int m = N_FFT - i;
+        float xr = 0.5f * (fft_real[i] + fft_real[m]);
+        float xi = 0.5f * (fft_imag[i] - fft_imag[m]);
+        float yr = 0.5f * (fft_imag[i] + fft_imag[m]);
+        float yi = 0.5f * (fft_real[m] - fft_real[i]);
+        
+        frame->energy1[band] += xr * xr + xi * xi;
+        frame->energy2[band] += yr * yr + yi * yi;
+        frame->crossRe[band] += xr * yr + xi * yi;
+        frame->crossIm[band] += xi * yr - xr * yi;
+    }
+}
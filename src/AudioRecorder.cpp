@@ -5,15 +5,26 @@
 #include "AudioRecorder.h"
 #include "utils.h"
 #include "main.h"
+#include "Resampler.h"
+#include "Beamformer.h"
+#include "AdcStream.h"
 
 
-const float PITCH_FACTOR = 2; // 0.5 = octave down, 1.0 = normal, 2.0 = octave up
+// Wake-word audio is stretched by PITCH_UP/PITCH_DOWN before the model sees
+// it (2/1: the first half-second fills the buffer, an octave lower).
+// Two taps is linear interpolation, which is what the model was trained on.
+const int PITCH_UP = 2;
+const int PITCH_DOWN = 1;
+const int PITCH_TAPS = 2;
 
+// Beam samples the pitch view can reach: BUFFER_SIZE outputs at PITCH_UP/
+// PITCH_DOWN plus the resampler's lookahead
+const int BEAM_LENGTH = (BUFFER_SIZE * PITCH_DOWN + PITCH_UP - 1) / PITCH_UP + PITCH_TAPS / 2;
 
-int16_t* ringBuffer1 = nullptr;
-int16_t* ringBuffer2 = nullptr;
-int16_t* pitchBuffer1 = nullptr;
-int16_t* pitchBuffer2 = nullptr;
+
+int16_t* ringBuffer1 = nullptr;     // Wit.ai: beamformed mic 1/mic 2
+AudioBlock captureBlock;            // Wake word: interleaved mic 1/mic 2 frames
+int16_t* beamBuffer = nullptr;      // Wake word: steered mic 1 + mic 2
 
 size_t currentBufferSize = 0;
 
@@ -23,44 +34,63 @@ volatile bool shouldRecord = false;
 volatile int writeIndex = 0;
 volatile bool bufferReady = false;
 volatile bool dataReadyToConsume = false;  
+int beamAdvance = -1;                // Beam view shift since the last window, -1: fresh
+
+// Kernel behind the pitch views; the stretched audio is never stored
+Resampler pitchResampler;
+
+// Shared by both captures: the Wit.ai command keeps the wake word's aim
+Beamformer beamformer;
+
+// Adaptive gain for the Wit.ai command and the capture listener (DTMF).
+// It follows the listener copy during the wake word, so the command
+// starts at the level the room settled on.
+AutoGain micGain;
+
+// The wake-word model was trained on a fixed x50 from the raw ADC; the
+// laser checks read the same block
+const int32_t WAKE_GAIN_Q8 = 50 << 8;
+AutoGain wakeGain(WAKE_GAIN_Q8, false);
+
+// AGC copy of a chunk captured at another gain, for the listener
+int16_t listenerFrames[2 * CAPTURE_CHUNK];
+
+// The ADC samples both mics by DMA; a full hop of slack lets the wake
+// word's features for one hop take as long as the hop itself
+const uint32_t CAPTURE_POOL_FRAMES = WAKE_HOP;
+AdcStream micStream;
+uint16_t rawFrames[2 * CAPTURE_CHUNK];
 
 
-void stopRecording();
-void applyPitchShift();
 void sendBufferData();
 
 
 void freeBuffers() {
   freeAudioBuffer(ringBuffer1, "ringBuffer1");
-  freeAudioBuffer(ringBuffer2, "ringBuffer2");
-  freeAudioBuffer(pitchBuffer1, "pitchBuffer1");
-  freeAudioBuffer(pitchBuffer2, "pitchBuffer2");
+  captureBlock.release("captureBlock");
+  freeAudioBuffer(beamBuffer, "beamBuffer");
   
   ringBuffer1 = nullptr;
-  ringBuffer2 = nullptr;
-  pitchBuffer1 = nullptr;
-  pitchBuffer2 = nullptr;
+  beamBuffer = nullptr;
   buffersAllocated = false;
   currentBufferSize = 0;
 }
 
 
-// Allocate 4 buffers for wake word (1 second each)
+// Allocate the dual-mic wake word capture (1 second)
 bool allocateWakeWordBuffers() {
   checkMemory("Before wake word buffer allocation");
   
   freeBuffers();
   
-  ringBuffer1 = (int16_t*)allocateAudioBuffer(BUFFER_SIZE, "ringBuffer1");
-  ringBuffer2 = (int16_t*)allocateAudioBuffer(BUFFER_SIZE, "ringBuffer2");
-  pitchBuffer1 = (int16_t*)allocateAudioBuffer(BUFFER_SIZE, "pitchBuffer1");
-  pitchBuffer2 = (int16_t*)allocateAudioBuffer(BUFFER_SIZE, "pitchBuffer2");
+  captureBlock.allocate(2, BUFFER_SIZE, "captureBlock");
+  beamBuffer = (int16_t*)allocateAudioBuffer(BEAM_LENGTH, "beamBuffer");
   
-  buffersAllocated = ringBuffer1 && ringBuffer2 && pitchBuffer1 && pitchBuffer2;
+  buffersAllocated = captureBlock.isAllocated() && beamBuffer != nullptr;
   currentBufferSize = BUFFER_SIZE;
   
   if (buffersAllocated) {
-    Serial.println("[MEMORY] Successfully allocated 4 wake word buffers (1 second each)");
+    Serial.println("[MEMORY] Successfully allocated wake word capture (1 second, 2 mics)");
   } else {
     Serial.println("[MEMORY] ERROR: Wake word buffer allocation failed!");
     freeBuffers();
@@ -78,11 +108,6 @@ bool allocateWitBuffers() {
   // Only allocate ringBuffer1 for Wit.ai
   ringBuffer1 = (int16_t*)allocateAudioBuffer(BUFFER_SIZE_MIC1, "ringBuffer1");
   
-  // Set other buffers to nullptr (not needed for Wit.ai)
-  ringBuffer2 = nullptr;
-  pitchBuffer1 = nullptr;
-  pitchBuffer2 = nullptr;
-  
   buffersAllocated = ringBuffer1 != nullptr;
   currentBufferSize = BUFFER_SIZE_MIC1;
   
@@ -97,73 +122,173 @@ bool allocateWitBuffers() {
 }
 
 
+// Mic bias needs time to settle after power-up before samples are usable
+const unsigned long MIC_SETTLE_MS = 2000;
+unsigned long micReadyAt = 0;
+
 void MIC_setup() {
   
-  analogReadResolution(12);
-  analogSetAttenuation(ADC_11db);
-  
-  pinMode(micPin1, INPUT);
-  pinMode(micPin2, INPUT);
+  const int pins[] = {micPin1, micPin2};
+  if (!micStream.begin(pins, 2, SAMPLE_RATE, CAPTURE_POOL_FRAMES)) {
+    Serial.println("[ADC] ERROR: Continuous capture did not start!");
+  }
   
-  delay(2000);
+  micReadyAt = millis() + MIC_SETTLE_MS;
+  pitchResampler.begin(PITCH_UP, PITCH_DOWN, PITCH_TAPS);
   Serial.println("DUAL MIC RING BUFFER READY");
   Serial.println("Send 'R' to record 1 second, 'S' to stop");
-  Serial.print("Pitch factor: ");
-  Serial.println(PITCH_FACTOR);
+  Serial.printf("Pitch factor: %d/%d\n", PITCH_UP, PITCH_DOWN);
+}
+
+bool MIC_isReady() {
+  return (long)(millis() - micReadyAt) >= 0;
+}
+
+CaptureListener captureListener = nullptr;
+void* captureListenerContext = nullptr;
+
+// Work charged to capture chunks since the last MIC_printLoad()
+uint32_t loadChunks = 0;
+uint32_t loadOverBudget = 0;
+uint32_t loadTotalMicros = 0;
+uint32_t loadListenerMicros = 0;
+uint32_t loadMaxMicros = 0;
+uint32_t chunkWorkMicros = 0;
+uint32_t loadOverrunsSeen = 0;
+
+void MIC_chargeWork(uint32_t micros) {
+  uint32_t before = chunkWorkMicros;
+  chunkWorkMicros += micros;
+  loadTotalMicros += micros;
+  
+  if (chunkWorkMicros > loadMaxMicros) loadMaxMicros = chunkWorkMicros;
+  if (chunkWorkMicros > CHUNK_BUDGET_MICROS && before <= CHUNK_BUDGET_MICROS) loadOverBudget++;
+}
+
+void MIC_printLoad(const char* label) {
+  uint32_t average = loadChunks ? loadTotalMicros / loadChunks : 0;
+  uint32_t overruns = micStream.getOverruns();
+  Serial.printf("[LOAD] %s: %lu chunks, avg %lu us (listener %lu), max %lu us, budget %lu us, %lu over, %lu overruns\n",
+                label, (unsigned long)loadChunks, (unsigned long)average,
+                (unsigned long)(loadChunks ? loadListenerMicros / loadChunks : 0),
+                (unsigned long)loadMaxMicros, (unsigned long)CHUNK_BUDGET_MICROS,
+                (unsigned long)loadOverBudget, (unsigned long)(overruns - loadOverrunsSeen));
+  loadOverrunsSeen = overruns;
+  
+  loadChunks = 0;
+  loadOverBudget = 0;
+  loadTotalMicros = 0;
+  loadListenerMicros = 0;
+  loadMaxMicros = 0;
+}
+
+void MIC_setListener(CaptureListener listener, void* context) {
+  captureListener = listener;
+  captureListenerContext = context;
+}
+
+// The one capture engine: count interleaved frames at 16kHz through gain.
+// The ADC keeps sampling while the caller works; this only waits for the
+// frames. The listener always hears the AGC; at any other gain it gets
+// its own copy.
+void MIC_readFrames(int16_t* frames, int count, AutoGain& gain) {
+  int16_t* agcFrames = (captureListener && &gain != &micGain) ? listenerFrames : nullptr;
+  
+  if (!micStream.read(rawFrames, count)) {
+    Serial.println("[ADC] Capture stalled, holding the last reading");
+  }
+  
+  for (int i = 0; i < count; i++) {
+    int raw1 = rawFrames[2 * i];
+    int raw2 = rawFrames[2 * i + 1];
+    frames[2 * i] = gain.process(0, raw1);
+    frames[2 * i + 1] = gain.process(1, raw2);
+    if (agcFrames) {
+      agcFrames[2 * i] = micGain.process(0, raw1);
+      agcFrames[2 * i + 1] = micGain.process(1, raw2);
+    }
+  }
+  gain.endBlock();
+  if (agcFrames) micGain.endBlock();
+  
+  // Each chunk opens a fresh budget; consumers charge to it as they run
+  loadChunks++;
+  chunkWorkMicros = 0;
+  
+  if (captureListener) {
+    unsigned long listenerStart = micros();
+    captureListener(agcFrames ? agcFrames : frames, count, captureListenerContext);
+    uint32_t elapsed = micros() - listenerStart;
+    loadListenerMicros += elapsed;
+    MIC_chargeWork(elapsed);
+  }
+}
+
+// Drops what the ADC captured while nobody was reading, so a new capture
+// starts now rather than up to a pool's length in the past
+void MIC_drain() {
+  micStream.drain();
+}
+
+// Capture for the listener alone, when no recording buffer is in use
+void MIC_stream() {
+  int16_t frames[2 * CAPTURE_CHUNK];
+  MIC_readFrames(frames, CAPTURE_CHUNK);
+}
+
+//for debugging; returns false for commands it does not know
+bool MIC_command(char command) {
+  if (command == 'S' || command == 's') {
+    stopRecording();
+    continuousRecording = false;  // Stop continuous recording
+  } else if (command == 'R' || command == 'r') {
+    continuousRecording = true;   // Restart continuous recording
+    startRecording();
+  } else {
+    return false;
+  }
+  return true;
 }
 
 bool MIC_loop() {
 
-  if (!buffersAllocated || !ringBuffer1) {
+  if (!buffersAllocated || !captureBlock.isAllocated()) {
     Serial.println("ERROR: Buffers not allocated in MIC_loop!");
     return false;
   }
-  // Check if we're using wake word configuration (4 buffers)
-  bool isWakeWordMode = (ringBuffer2 != nullptr && pitchBuffer1 != nullptr && pitchBuffer2 != nullptr);
-  
-
-  //for debugging
-  if (Serial.available() > 0) {
-    char command = Serial.read();
-    if (command == 'S' || command == 's') {
-      stopRecording();
-      continuousRecording = false;  // Stop continuous recording
-    } else if (command == 'R' || command == 'r') {
-      continuousRecording = true;   // Restart continuous recording
-      startRecording();
-    }
-  }
 
   // Auto-start recording if in continuous mode and not currently recording
   if (continuousRecording && !shouldRecord && !bufferReady) {
-    startRecording();
+    continueRecording();
   }
   
   // If recording, fill ring buffer
   if (shouldRecord) {
-    unsigned long startTime = micros();
+    // Frames land straight in the interleaved capture block
+    int count = BUFFER_SIZE - writeIndex;
+    if (count > CAPTURE_CHUNK) count = CAPTURE_CHUNK;
+    MIC_readFrames(captureBlock.frameAt(writeIndex), count, wakeGain);
+    captureBlock.commit(count);
+    writeIndex += count;
     
-    for (int i = 0; i < 100; i++) { // Read 100 samples at a time
-      if (writeIndex >= BUFFER_SIZE) {
-        bufferReady = true;
-        shouldRecord = false;
-        writeIndex = 0;
-        break;
-      }
-      
-      // Read both mics
-      if(defenceSet) ringBuffer1[writeIndex] = (int16_t)((analogRead(micPin1) - 2048) * 50);
-      else ringBuffer1[writeIndex] = (int16_t)((analogRead(micPin1) - 2048) * 50);
-      ringBuffer2[writeIndex] = (int16_t)((analogRead(micPin2) - 2048) * 50);
-      writeIndex++;
-      
-      // Timing for 16kHz
-      while (micros() - startTime < (i + 1) * 62.5) {}
+    if (writeIndex >= BUFFER_SIZE) {
+      bufferReady = true;
+      shouldRecord = false;
+      writeIndex = 0;
     }
     
+    // Laser statistics follow the capture so they are ready with the buffer
+    unsigned long laserStart = micros();
+    laserDetector->onSamples(captureBlock.getLength());
+    MIC_chargeWork(micros() - laserStart);
+    
     // If buffer is full, process and send data
     if (bufferReady) {
-      applyPitchShift();
+      MIC_printLevels("wake", wakeGain);
+      MIC_printLoad("wake");
+      beamformer.steerFrom(captureBlock);
+      beamformer.render(captureBlock, beamBuffer, BEAM_LENGTH);
+      
       // sendBufferData(); //for debugging
       bufferReady = false;
       dataReadyToConsume = true; 
@@ -179,7 +304,7 @@ void acknowledgeData() {
 }
 
 void startRecording() {
-  if (!buffersAllocated || !ringBuffer1) {
+  if (!buffersAllocated || !captureBlock.isAllocated()) {
     Serial.println("ERROR: Buffers not allocated in startRecording!");
     return;
   }
@@ -187,61 +312,76 @@ void startRecording() {
   writeIndex = 0;
   bufferReady = false;
   shouldRecord = true;
+  beamAdvance = -1;
+  MIC_drain();
+  
+  captureBlock.clear();
+  wakeGain.resetStats();
+  laserDetector->beginCapture(captureBlock);
   Serial.println("RECORDING STARTED - Filling 1 second buffer...");
 }
 
+// Slides the wake-word window on by WAKE_HOP frames, so consecutive
+// windows overlap; starts over when there is no full window to slide
+void continueRecording() {
+  if (!buffersAllocated || captureBlock.getLength() < BUFFER_SIZE) {
+    startRecording();
+    return;
+  }
+  
+  captureBlock.discard(WAKE_HOP);
+  writeIndex = captureBlock.getLength();
+  bufferReady = false;
+  shouldRecord = true;
+  beamAdvance = WAKE_HOP * PITCH_UP / PITCH_DOWN;
+  
+  // The laser statistics restart over the retained frames on the next chunk
+  wakeGain.resetStats();
+  laserDetector->beginCapture(captureBlock);
+}
+
 void stopRecording() {
   shouldRecord = false;
   Serial.println("RECORDING STOPPED");
 }
 
-// Simple pitch shifting using linear interpolation
-void applyPitchShift() {
-  int outputSamples = (int)(BUFFER_SIZE * PITCH_FACTOR);
-  if (outputSamples > BUFFER_SIZE) outputSamples = BUFFER_SIZE;
-  
-  for (int i = 0; i < outputSamples; i++) {
-    // Calculate the source position with floating point precision
-    float srcPos = i / PITCH_FACTOR;
-    int srcIndex = (int)srcPos;
-    float frac = srcPos - srcIndex;
-    
-    if (srcIndex < BUFFER_SIZE - 1) {
-      // Linear interpolation for mic 1
-      pitchBuffer1[i] = (int16_t)(
-        ringBuffer1[srcIndex] * (1.0f - frac) + 
-        ringBuffer1[srcIndex + 1] * frac
-      );
-      
-      // Linear interpolation for mic 2
-      pitchBuffer2[i] = (int16_t)(
-        ringBuffer2[srcIndex] * (1.0f - frac) + 
-        ringBuffer2[srcIndex + 1] * frac
-      );
-    } else if (srcIndex < BUFFER_SIZE) {
-      // Last sample
-      pitchBuffer1[i] = ringBuffer1[srcIndex];
-      pitchBuffer2[i] = ringBuffer2[srcIndex];
-    } else {
-      // Pad with silence if needed
-      pitchBuffer1[i] = 0;
-      pitchBuffer2[i] = 0;
-    }
-  }
-  
-  // Pad the rest with silence if output is shorter
-  for (int i = outputSamples; i < BUFFER_SIZE; i++) {
-    pitchBuffer1[i] = 0;
-    pitchBuffer2[i] = 0;
-  }
+// Beamformed wake-word audio as the model sees it, resampled on every read
+SampleView MIC_beamView() {
+  return SampleView::resampled(&pitchResampler, beamBuffer, BEAM_LENGTH, BUFFER_SIZE);
+}
+
+// Model-rate samples the beam view moved since the previous window, or -1
+// when the window was recorded from scratch
+int MIC_beamAdvance() {
+  return beamAdvance;
+}
+
+// Single wake-word mic, resampled the same way as the beam
+SampleView MIC_pitchView(int channel) {
+  const int16_t* samples = captureBlock.data() + (channel == 2 ? 1 : 0);
+  return SampleView::resampled(&pitchResampler, samples, captureBlock.getLength(), BUFFER_SIZE,
+                               captureBlock.getChannels());
+}
+
+void MIC_printLevels(const char* label, AutoGain& gain) {
+  const AutoGain::Stats& stats = gain.getStats();
+  Serial.printf("[AGC] %s: gain %.1fx, peak %ld, clipped %lu/%lu, dc %d/%d\n",
+                label, stats.gainQ8 / 256.0f, (long)stats.peak,
+                (unsigned long)stats.clipped, (unsigned long)stats.samples,
+                stats.dc[0], stats.dc[1]);
 }
 
 void sendBufferData() {
   Serial.write(0xFF);
   Serial.write(0xAA);
   // Send pitch-shifted buffers instead of original
-  Serial.write((uint8_t*)pitchBuffer1, BUFFER_SIZE * 2);
-  Serial.write((uint8_t*)pitchBuffer2, BUFFER_SIZE * 2);
+  for (int channel = 1; channel <= 2; channel++) {
+    SampleView view = MIC_pitchView(channel);
+    for (int i = 0; i < view.length; i++) {
+      int16_t sample = view[i];
+      Serial.write((uint8_t*)&sample, 2);
+    }
+  }
   Serial.println("BUFFER_SENT");
 }
 
@@ -0,0 +1,56 @@
+// ============================================================================
+// AutoGain.cpp - ADC front end: DC tracking, block AGC, saturation counters
+// ============================================================================
+#include "AutoGain.h"
+
+AutoGain::AutoGain(int32_t initialGainQ8, bool adaptive) : adaptive(adaptive), gainQ8(initialGainQ8) {
+    for (int c = 0; c < MAX_CHANNELS; c++) {
+        dcQ12[c] = 2048 << 12;      // Mid-scale until the first reading
+    }
+    resetStats();
+}
+
+void AutoGain::prime(int channel, int raw) {
+    // Start the bias at the first reading instead of letting a mid-scale
+    // guess decay in over the first quarter second
+    dcQ12[channel] = raw << 12;
+    primed |= 1 << channel;
+}
+
+void AutoGain::endBlock() {
+    if (blockPeak > stats.peak) stats.peak = blockPeak;
+
+    if (!adaptive) {
+        blockPeak = 0;
+        return;
+    }
+
+    if (blockPeak > TARGET_PEAK) {
+        // Attack: bring this block's peak down to the target right away
+        gainQ8 = (int32_t)(((int64_t)gainQ8 * TARGET_PEAK) / blockPeak);
+    } else if (blockPeak < TARGET_PEAK / 2) {
+        // Release: creep up, never past what this block could take
+        int32_t next = gainQ8 + (gainQ8 >> RELEASE_SHIFT) + 1;
+        int32_t allowed = blockPeak > 0
+            ? (int32_t)(((int64_t)gainQ8 * TARGET_PEAK) / blockPeak) : MAX_GAIN_Q8;
+        gainQ8 = next < allowed ? next : allowed;
+    }
+
+    if (gainQ8 < MIN_GAIN_Q8) gainQ8 = MIN_GAIN_Q8;
+    if (gainQ8 > MAX_GAIN_Q8) gainQ8 = MAX_GAIN_Q8;
+    blockPeak = 0;
+}
+
+const AutoGain::Stats& AutoGain::getStats() {
+    stats.gainQ8 = gainQ8;
+    for (int c = 0; c < MAX_CHANNELS; c++) {
+        stats.dc[c] = (int16_t)(dcQ12[c] >> 12);
+    }
+    return stats;
+}
+
+void AutoGain::resetStats() {
+    stats.samples = 0;
+    stats.clipped = 0;
+    stats.peak = 0;
+}
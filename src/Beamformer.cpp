@@ -0,0 +1,144 @@
+// ============================================================================
+// Beamformer.cpp - Two-mic delay-and-sum beamformer (fixed-point steering)
+// ============================================================================
+#include "Beamformer.h"
+
+static const int HALF_TAPS = Beamformer::TAPS / 2;
+static const int COEFF_ONE = 1 << 14;
+
+Beamformer::Beamformer() {
+    design();
+    steer(0);
+    reset();
+}
+
+void Beamformer::design() {
+    for (int p = 0; p < FRACTIONS; p++) {
+        double fraction = (double)p / FRACTIONS;
+        double h[TAPS];
+        double sum = 0.0;
+
+        // Tap k weights the sample k - (HALF_TAPS - 1) before the delayed
+        // instant, so t is that sample's distance from the ideal point
+        for (int k = 0; k < TAPS; k++) {
+            double t = (k - (HALF_TAPS - 1)) - fraction;
+            double sinc = (t == 0.0) ? 1.0 : sin(PI * t) / (PI * t);
+            double hann = 0.5 * (1.0 + cos(PI * t / HALF_TAPS));
+            h[k] = sinc * hann;
+            sum += h[k];
+        }
+
+        // Per-phase normalisation keeps unity gain; rounding slack goes to
+        // the largest tap so every phase sums to exactly 1.0
+        int total = 0;
+        int largest = 0;
+        for (int k = 0; k < TAPS; k++) {
+            coeffs[p][k] = (int16_t)lround(h[k] / sum * COEFF_ONE);
+            total += coeffs[p][k];
+            if (abs(coeffs[p][k]) > abs(coeffs[p][largest])) largest = k;
+        }
+        coeffs[p][largest] += COEFF_ONE - total;
+    }
+}
+
+void Beamformer::reset() {
+    memset(line1, 0, sizeof(line1));
+    memset(line2, 0, sizeof(line2));
+    position = 0;
+}
+
+void Beamformer::steer(int16_t tdoaQ8) {
+    const int limit = GccPhat::MAX_LAG * 256;
+    if (tdoaQ8 > limit) tdoaQ8 = limit;
+    if (tdoaQ8 < -limit) tdoaQ8 = -limit;
+
+    steeringQ8 = tdoaQ8;
+    leadIsMic2 = tdoaQ8 > 0;
+
+    // Round the magnitude to the FIR table's 1/FRACTIONS grid
+    int steps = ((leadIsMic2 ? tdoaQ8 : -tdoaQ8) * FRACTIONS + 128) >> 8;
+    delayWhole = steps / FRACTIONS;
+    delayTaps = coeffs[steps % FRACTIONS];
+}
+
+bool Beamformer::steerFrom(const AudioBlock& block) {
+    const int n = GccPhat::FRAME_SIZE;
+    int frameCount = block.getLength() / n;
+    if (block.getChannels() != 2 || frameCount == 0) return false;
+
+    // Direction is clearest where the talker is loudest
+    const int16_t* in = block.data();
+    int loudest = 0;
+    uint32_t loudestLevel = 0;
+    for (int f = 0; f < frameCount; f++) {
+        const int16_t* frame = in + f * n * 2;
+        uint32_t level = 0;
+        for (int i = 0; i < n * 2; i++) {
+            level += abs(frame[i]);
+        }
+        if (level > loudestLevel) {
+            loudestLevel = level;
+            loudest = f;
+        }
+    }
+
+    block.copyChannels(loudest * n, n, frame1, frame2);
+    GccPhat::Estimate e = gcc.estimate(frame1, frame2);
+
+    if (e.sharpness < MIN_SHARPNESS) {
+        Serial.printf("[BEAM] No clear direction (sharpness %u), keeping %.2f samples\n",
+                      e.sharpness, steeringQ8 / 256.0f);
+        return false;
+    }
+
+    steer(e.tdoaQ8);
+    Serial.printf("[BEAM] Steering %.2f samples (sharpness %u)\n", steeringQ8 / 256.0f, e.sharpness);
+    return true;
+}
+
+int16_t Beamformer::push(int16_t s1, int16_t s2) {
+    line1[position] = s1;
+    line2[position] = s2;
+
+    const int16_t* lead = leadIsMic2 ? line2 : line1;
+    const int16_t* lag = leadIsMic2 ? line1 : line2;
+
+    // Both mics trail by LATENCY; the lead mic additionally by the TDOA.
+    // Tap 0 reads the newest sample the fractional FIR needs.
+    int32_t acc = (int32_t)lag[(position - LATENCY) & LINE_MASK] * COEFF_ONE;
+    int newest = position - delayWhole;
+    for (int k = 0; k < TAPS; k++) {
+        acc += (int32_t)delayTaps[k] * lead[(newest - k) & LINE_MASK];
+    }
+
+    position = (position + 1) & LINE_MASK;
+
+    // Average of the two aligned mics, rounded back from Q14
+    acc = (acc + COEFF_ONE) >> 15;
+    if (acc > 32767) acc = 32767;
+    if (acc < -32768) acc = -32768;
+    return (int16_t)acc;
+}
+
+void Beamformer::process(const int16_t* frames, int count, int16_t* out) {
+    for (int i = 0; i < count; i++) {
+        out[i] = push(frames[2 * i], frames[2 * i + 1]);
+    }
+}
+
+void Beamformer::render(const AudioBlock& block, int16_t* out, int count) {
+    reset();
+
+    const int16_t* in = block.data();
+    int available = block.getChannels() == 2 ? block.getLength() : 0;
+
+    for (int i = 0; i < count + LATENCY; i++) {
+        int16_t s1 = 0, s2 = 0;
+        if (i < available) {
+            s1 = in[2 * i];
+            s2 = in[2 * i + 1];
+        }
+        int16_t y = push(s1, s2);
+        if (i >= LATENCY) out[i - LATENCY] = y;
+    }
+}
@@ -0,0 +1,129 @@
+// ============================================================================
+// CorrelationEngine.cpp - O(1) windowed correlation from prefix moments
+// ============================================================================
+#include "CorrelationEngine.h"
+#include "DspMath.h"
+
+void CorrelationEngine::begin(const int16_t* x, const int16_t* y, size_t capacity, size_t alignment,
+                              int stride) {
+    bufX = x;
+    bufY = y;
+    this->stride = stride;
+    length = 0;
+    this->capacity = capacity;
+
+    // Coarsen the blocks if the table would not fit; edge scans cover the rest
+    blockSize = alignment > 0 ? alignment : 1;
+    size_t minBlock = (capacity + MAX_BLOCKS - 1) / MAX_BLOCKS;
+    if (blockSize < minBlock) blockSize = minBlock;
+
+    Moments zero = {0, 0, 0, 0, 0};
+    running = zero;
+    prefix[0] = zero;
+}
+
+void CorrelationEngine::extend(size_t newLength) {
+    if (newLength > capacity) newLength = capacity;
+
+    while (length < newLength) {
+        // Accumulate up to the next block boundary, or as far as we have
+        size_t nextBoundary = (length / blockSize + 1) * blockSize;
+        size_t to = nextBoundary < newLength ? nextBoundary : newLength;
+
+        accumulate(running, length, to);
+        length = to;
+
+        if (length == nextBoundary) {
+            prefix[length / blockSize] = running;
+        }
+    }
+}
+
+void CorrelationEngine::build(const int16_t* x, const int16_t* y, size_t length, size_t alignment) {
+    begin(x, y, length, alignment);
+    extend(length);
+}
+
+void CorrelationEngine::accumulate(Moments& m, size_t from, size_t to) const {
+    for (size_t i = from; i < to; i++) {
+        int32_t a = bufX[i * stride];
+        int32_t b = bufY[i * stride];
+        m.sx  += a;
+        m.sy  += b;
+        m.sxx += a * a;
+        m.syy += b * b;
+        m.sxy += a * b;
+    }
+}
+
+CorrelationEngine::Moments CorrelationEngine::moments(size_t start, size_t count) const {
+    Moments m = {0, 0, 0, 0, 0};
+    size_t end = start + count;
+    if (end > length) end = length;
+    if (start >= end) return m;
+
+    // Nearest recorded prefixes inside [start, end); the running total
+    // stands in for the partial block at the end of the data
+    size_t kStart = (start + blockSize - 1) / blockSize;
+    size_t loBoundary = kStart * blockSize;
+    size_t hiBoundary = (end == length) ? length : (end / blockSize) * blockSize;
+
+    if (loBoundary >= hiBoundary) {
+        accumulate(m, start, end);
+        return m;
+    }
+
+    const Moments& hi = (end == length) ? running : prefix[end / blockSize];
+    const Moments& lo = prefix[kStart];
+    m.sx  = hi.sx  - lo.sx;
+    m.sy  = hi.sy  - lo.sy;
+    m.sxx = hi.sxx - lo.sxx;
+    m.syy = hi.syy - lo.syy;
+    m.sxy = hi.sxy - lo.sxy;
+
+    accumulate(m, start, loBoundary);
+    accumulate(m, hiBoundary, end);
+    return m;
+}
+
+int16_t CorrelationEngine::correlationQ8(size_t start, size_t count) const {
+    size_t end = start + count;
+    if (end > length) end = length;
+    if (start >= end) return 0;
+    return correlationQ8(moments(start, end - start), end - start);
+}
+
+int16_t CorrelationEngine::correlationQ8(const Moments& m, size_t n) {
+    if (n == 0) return 0;
+
+    // Centred sums scaled by n: n*sum((x-mean)^2) = n*sxx - sx^2.
+    // Stays within int64 for up to ~64k full-scale 16-bit samples.
+    int64_t count = (int64_t)n;
+    int64_t c11 = count * m.sxx - m.sx * m.sx;
+    int64_t c22 = count * m.syy - m.sy * m.sy;
+    int64_t c12 = count * m.sxy - m.sx * m.sy;
+
+    // Avoid division by zero
+    if (c11 <= 0 || c22 <= 0) {
+        return 0;
+    }
+
+    // Exact Pearson denominator sqrt(c11 * c22). The product itself would
+    // overflow, so take each root separately; both are ~30-bit so the
+    // product fits and the floor error is negligible at audio levels.
+    int64_t denom = (int64_t)isqrt64(c11) * isqrt64(c22);
+
+    // Scale the denominator rather than c12 so the Q8 shift cannot overflow
+    int64_t correlation;
+    if (denom >= 256) {
+        correlation = c12 / (denom >> 8);
+    } else {
+        correlation = (c12 * 256) / (denom > 0 ? denom : 1);
+    }
+
+    // Clamp to valid range
+    if (correlation > 256) correlation = 256;
+    if (correlation < 0) correlation = 0;  // Use 0 instead of abs()
+
+    return (int16_t)correlation;
+}
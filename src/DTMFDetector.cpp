@@ -9,122 +9,46 @@ constexpr float DTMFDetector::DTMF_ROW[4];
 constexpr float DTMFDetector::DTMF_COL[4];
 constexpr char DTMFDetector::DTMF_CHAR[4][4];
 
-// Goertzel implementation
-void DTMFDetector::Goertzel::init(float freq, float sampleRate) {
-    float omega = (2.0 * PI * freq) / sampleRate;
-    cosine = cos(omega);
-    sine = sin(omega);
-    coeff = 2.0 * cosine;
-    reset();
-}
-
-void DTMFDetector::Goertzel::reset() {
-    Q1 = 0;
-    Q2 = 0;
-}
-
-void DTMFDetector::Goertzel::processSample(float sample) {
-    float Q0 = coeff * Q1 - Q2 + sample;
-    Q2 = Q1;
-    Q1 = Q0;
-}
-
-float DTMFDetector::Goertzel::getMagnitudeSquared() {
-    float real = (Q1 - Q2 * cosine);
-    float imag = (Q2 * sine);
-    return real * real + imag * imag;
-}
-
 // DTMFDetector implementation
 DTMFDetector::DTMFDetector() : 
     threshold(DTMF_DETECTION_THRESHOLD),
-    dcOffset(2048),
-    lastDetected('\0'),
-    lastDetectionTime(0),
-    audioBuffer(nullptr),
-    bufferAllocated(false),
+    pendingKey('\0'),
     cursorPos(0),
     isPM(true) {
     resetTimeEntry();
-}
-
-DTMFDetector::~DTMFDetector() {
-    freeBuffer();
-}
-
-bool DTMFDetector::allocateBuffer() {
-    if (bufferAllocated) {
-        return true;
-    }
-    
-    checkMemory("Before DTMF buffer allocation");
-    
-    // Use regular heap allocation instead of PSRAM (no PSRAM in ESP32S3)
-    audioBuffer = (int16_t*)malloc(DTMF_BUFFER_SIZE * sizeof(int16_t));
-    
-    if (audioBuffer) {
-        bufferAllocated = true;
-        memset(audioBuffer, 0, DTMF_BUFFER_SIZE * sizeof(int16_t));
-        Serial.printf("[DTMF] Buffer allocated successfully (%d bytes)\n", 
-                     DTMF_BUFFER_SIZE * sizeof(int16_t));
-        checkMemory("After DTMF buffer allocation");
-        return true;
-    } else {
-        Serial.println("[DTMF] ERROR: Buffer allocation failed!");
-        bufferAllocated = false;
-        return false;
-    }
-}
-
-void DTMFDetector::freeBuffer() {
-    if (audioBuffer && bufferAllocated) {
-        free(audioBuffer);
-        audioBuffer = nullptr;
-        bufferAllocated = false;
-        Serial.println("[DTMF] Buffer freed");
-        checkMemory("After DTMF buffer free");
-    }
+    resetStream();
 }
 
 void DTMFDetector::init() {
     // Initialize Goertzel filters
+    float freqs[GoertzelBank::FILTERS];
     for (int i = 0; i < 4; i++) {
-        rowTones[i].init(DTMF_ROW[i], DTMF_SAMPLE_RATE);
-        colTones[i].init(DTMF_COL[i], DTMF_SAMPLE_RATE);
+        freqs[i] = DTMF_ROW[i];
+        freqs[4 + i] = DTMF_COL[i];
+    }
+    for (int b = 0; b < 2; b++) {
+        banks[b].filters.init(freqs, DTMF_SAMPLE_RATE);
     }
+    decimator.begin(1, 2, DTMF_DECIMATE_TAPS);
+    resetStream();
     Serial.println("[DTMF] Detector initialized");
 }
 
-void DTMFDetector::calibrateDCOffset(int micPin) {
-    Serial.println("[DTMF] Calibrating DC offset...");
-    long sum = 0;
-    for (int i = 0; i < 1000; i++) {
-        sum += analogRead(micPin);
-        delayMicroseconds(100);
+void DTMFDetector::resetStream() {
+    for (int b = 0; b < 2; b++) {
+        banks[b].filters.reset();
+        banks[b].count = -b * DTMF_BLOCK_HOP;
     }
-    dcOffset = sum / 1000;
-    Serial.printf("[DTMF] DC Offset calibrated: %d\n", dcOffset);
+    decimator.reset();
+    previousBlock = '\0';
+    heldKey = '\0';
+    pendingKey = '\0';
 }
 
-char DTMFDetector::detectTone() {
-    if (!bufferAllocated || !audioBuffer) {
-        return '\0';
-    }
-    
-    // Reset filters
-    for (int i = 0; i < 4; i++) {
-        rowTones[i].reset();
-        colTones[i].reset();
-    }
-    
-    // Process samples
-    for (int i = 0; i < DTMF_BUFFER_SIZE; i++) {
-        float sample = audioBuffer[i] / 2048.0;  // Normalize
-        for (int j = 0; j < 4; j++) {
-            rowTones[j].processSample(sample);
-            colTones[j].processSample(sample);
-        }
-    }
+char DTMFDetector::detectTone(Bank& bank) {
+    // Powers with samples normalized to full scale
+    float power[GoertzelBank::FILTERS];
+    bank.filters.magnitudes(power, 1.0f / (32768.0f * 32768.0f));
     
     // Find peaks
     float maxRowPower = 0;
@@ -133,8 +57,8 @@ char DTMFDetector::detectTone() {
     int maxColIndex = -1;
     
     for (int i = 0; i < 4; i++) {
-        float rowPower = rowTones[i].getMagnitudeSquared();
-        float colPower = colTones[i].getMagnitudeSquared();
+        float rowPower = power[i];
+        float colPower = power[4 + i];
         
         if (rowPower > maxRowPower) {
             maxRowPower = rowPower;
@@ -152,8 +76,8 @@ char DTMFDetector::detectTone() {
         // Validate - check if significantly stronger than others
         bool valid = true;
         for (int i = 0; i < 4; i++) {
-            float rowPower = rowTones[i].getMagnitudeSquared();
-            float colPower = colTones[i].getMagnitudeSquared();
+            float rowPower = power[i];
+            float colPower = power[4 + i];
             
             if (i != maxRowIndex && rowPower * 2.5 > maxRowPower) valid = false;
             if (i != maxColIndex && colPower * 2.5 > maxColPower) valid = false;
@@ -167,38 +91,72 @@ char DTMFDetector::detectTone() {
     return '\0';
 }
 
-char DTMFDetector::recordAndDetect(int micPin) {
-    if (!bufferAllocated || !audioBuffer) {
-        return '\0';
-    }
+char DTMFDetector::decide(char block) {
+    // Two agreeing sub-blocks (~38 ms of tone) confirm a key; it is reported
+    // once and re-armed only after a sub-block without it
+    char confirmed = (block != '\0' && block == previousBlock) ? block : '\0';
+    previousBlock = block;
     
-    // Record audio buffer at 8kHz
-    unsigned long startTime = micros();
-    for (int i = 0; i < DTMF_BUFFER_SIZE; i++) {
-        audioBuffer[i] = analogRead(micPin) - dcOffset;
-        
-        // Maintain 8kHz sample rate (125 microseconds per sample)
-        while (micros() - startTime < (i + 1) * 125) {}
+    if (block != heldKey) heldKey = '\0';
+    if (confirmed != '\0' && confirmed != heldKey) {
+        heldKey = confirmed;
+        return confirmed;
     }
+    return '\0';
+}
+
+char DTMFDetector::feed(const int16_t* samples, int count) {
+    char detected = '\0';
+    int i = 0;
     
-    // Detect DTMF tone
-    char detected = detectTone();
-    
-    // Debounce detection
-    if (detected != '\0') {
-        if (detected != lastDetected || millis() - lastDetectionTime > 200) {
-            lastDetected = detected;
-            lastDetectionTime = millis();
-            return detected;
+    while (i < count) {
+        // Run both banks up to the next point where either starts or ends
+        int run = count - i;
+        for (int b = 0; b < 2; b++) {
+            int left = banks[b].count < 0 ? -banks[b].count : DTMF_BLOCK_SIZE - banks[b].count;
+            if (left < run) run = left;
         }
-    } else {
-        // Reset after no detection
-        if (millis() - lastDetectionTime > 500) {
-            lastDetected = '\0';
+        
+        for (int b = 0; b < 2; b++) {
+            if (banks[b].count >= 0) banks[b].filters.process(samples + i, run);
+            banks[b].count += run;
+        }
+        i += run;
+        
+        for (int b = 0; b < 2; b++) {
+            Bank& bank = banks[b];
+            if (bank.count < DTMF_BLOCK_SIZE) continue;
+            
+            char key = decide(detectTone(bank));
+            if (key != '\0') detected = key;
+            
+            // Restart so the banks stay DTMF_BLOCK_HOP apart
+            bank.filters.reset();
+            bank.count = DTMF_BLOCK_SIZE - 2 * DTMF_BLOCK_HOP;
         }
     }
     
-    return '\0';
+    return detected;
+}
+
+void DTMFDetector::onCapture(const int16_t* frames, int count, void* context) {
+    static_cast<DTMFDetector*>(context)->feedCapture(frames, count);
+}
+
+void DTMFDetector::feedCapture(const int16_t* frames, int count) {
+    for (int i = 0; i < count; i += DTMF_CHUNK) {
+        int n = count - i < DTMF_CHUNK ? count - i : DTMF_CHUNK;
+        
+        int produced = decimator.process(frames + 2 * i, 2, n, decimated, DTMF_CHUNK / 2);
+        
+        char key = feed(decimated, produced);
+        if (key != '\0') pendingKey = key;
+    }
+}
+
+char DTMFDetector::takeKey() {
+    // One atomic swap, so a key the listener stores in between is not lost
+    return pendingKey.exchange('\0');
 }
 
 void DTMFDetector::resetTimeEntry() {
@@ -0,0 +1,88 @@
+// ============================================================================
+// GccPhat.cpp - Inter-mic delay estimate by PHAT-weighted cross-correlation
+// ============================================================================
+#include "GccPhat.h"
+
+GccPhat::GccPhat() {
+    for (int i = 0; i < FRAME_SIZE; i++) {
+        window[i] = 0.5 * (1.0 - cos(2.0 * PI * i / (FRAME_SIZE - 1)));
+    }
+}
+
+GccPhat::Estimate GccPhat::estimate(const int16_t* x, const int16_t* y) {
+    const int n = FRAME_SIZE;
+    Estimate result = {0, 0, 0};
+
+    // Both channels go through one complex FFT: z = x + j*y
+    for (int i = 0; i < n; i++) {
+        re[i] = (float)x[i] * window[i];
+        im[i] = (float)y[i] * window[i];
+    }
+    AudioProcessor::computeFFT(re, im, n);
+
+    // Split Z into X and Y via conjugate symmetry, form X * conj(Y) and keep
+    // only its phase. Bins k and n-k are handled together so the in-place
+    // writes never clobber a partner that is still needed.
+    for (int k = 0; k <= n / 2; k++) {
+        int m = (n - k) & (n - 1);
+        float a = re[k], b = im[k];
+        float c = re[m], d = im[m];
+
+        // X = ((a+c) + j(b-d)) / 2,  Y = ((b+d) + j(c-a)) / 2
+        float xr = 0.5f * (a + c), xi = 0.5f * (b - d);
+        float yr = 0.5f * (b + d), yi = 0.5f * (c - a);
+
+        float gr = xr * yr + xi * yi;
+        float gi = xi * yr - xr * yi;
+        float mag = sqrtf(gr * gr + gi * gi);
+
+        if (k == 0 || mag < 1e-3f) {
+            gr = 0.0f;
+            gi = 0.0f;
+        } else {
+            gr /= mag;
+            gi /= mag;
+        }
+
+        // Conjugated now so the forward FFT below acts as the inverse
+        re[k] = gr;
+        im[k] = -gi;
+        if (m != k) {
+            re[m] = gr;
+            im[m] = gi;
+        }
+    }
+
+    AudioProcessor::computeFFT(re, im, n);
+
+    // re[lag] / n is the PHAT correlation; negative lags wrap to the top
+    float peak = -1.0f;
+    int peakLag = 0;
+    for (int lag = -MAX_LAG; lag <= MAX_LAG; lag++) {
+        float r = re[lag & (n - 1)];
+        if (r > peak) {
+            peak = r;
+            peakLag = lag;
+        }
+    }
+
+    float sharpness = peak * 256.0f / n;
+    if (sharpness < 0.0f) sharpness = 0.0f;
+    if (sharpness > 255.0f) sharpness = 255.0f;
+
+    // Sub-sample offset from the parabola through the peak and its neighbours
+    float left = re[(peakLag - 1) & (n - 1)];
+    float right = re[(peakLag + 1) & (n - 1)];
+    float curvature = left - 2.0f * peak + right;
+    float offset = 0.0f;
+    if (curvature < 0.0f) {
+        offset = 0.5f * (left - right) / curvature;
+        if (offset > 0.5f) offset = 0.5f;
+        if (offset < -0.5f) offset = -0.5f;
+    }
+
+    result.tdoa = (int8_t)peakLag;
+    result.sharpness = (uint8_t)sharpness;
+    result.tdoaQ8 = (int16_t)lroundf((peakLag + offset) * 256.0f);
+    return result;
+}
@@ -0,0 +1,29 @@
+// ============================================================================
+// GoertzelBank.cpp - Fixed-point Goertzel filters in struct-of-arrays form
+// ============================================================================
+#include "GoertzelBank.h"
+
+void GoertzelBank::init(const float* freqs, float sampleRate) {
+    for (int f = 0; f < FILTERS; f++) {
+        float omega = (2.0 * PI * freqs[f]) / sampleRate;
+        coeffQ14[f] = (int32_t)lroundf(2.0f * cosf(omega) * 16384.0f);
+        coeff[f] = coeffQ14[f] / 16384.0f;
+    }
+    reset();
+}
+
+void GoertzelBank::reset() {
+    for (int f = 0; f < FILTERS; f++) {
+        s1[f] = 0;
+        s2[f] = 0;
+    }
+}
+
+void GoertzelBank::magnitudes(float* out, float scale) const {
+    scale *= (float)(1 << (2 * INPUT_SHIFT));
+    for (int f = 0; f < FILTERS; f++) {
+        float a = (float)s1[f];
+        float b = (float)s2[f];
+        out[f] = (a * a + b * b - coeff[f] * a * b) * scale;
+    }
+}
@@ -3,17 +3,53 @@
 // ============================================================================
 #include "LaserAttackDetector.h"
 
+void LaserAttackDetector::beginCapture(const AudioBlock& block) {
+    // Windows sit on the stride grid, so blocks of gcd(window, stride)
+    // answer every one of them from the prefix table alone. The moments
+    // read the interleaved frames in place.
+    engine.begin(block.data(), block.data() + 1, block.getCapacity(),
+                 gcd(WINDOW_SIZE, STRIDE), block.getChannels());
+    capture = &block;
+    if (spectra) spectraGenerationAtCapture = spectra->getGeneration();
+    windows = 0;
+    nextWindowStart = 0;
+    resultValid = false;
+}
+
+void LaserAttackDetector::onSamples(size_t captured) {
+    engine.extend(captured);
+    
+    // Score every window whose last sample has now arrived
+    while (nextWindowStart + WINDOW_SIZE <= engine.getLength() && windows < MAX_WINDOWS) {
+        windowCorr[windows++] = engine.correlationQ8(nextWindowStart, WINDOW_SIZE);
+        nextWindowStart += STRIDE;
+    }
+}
+
 // Calibration function - learns your mic characteristics
-void LaserAttackDetector::calibrate(int16_t* buf1, int16_t* buf2, size_t bufferSize) {
+void LaserAttackDetector::calibrate() {
     Serial.println("\nCalibrating laser detector...");
     
     // Calculate baseline correlation for your mics
-    baselineCorrelation = calculateCorrelationQ8(buf1, buf2, bufferSize);
+    baselineCorrelation = engine.correlationQ8(0, engine.getLength());
     isCalibrated = true;
+    resultValid = false;  // Thresholds changed
+    
+    DetectionResult delays;
+    analyzeDelays(delays);
+    if (delays.voicedFrames >= MIN_VOICED_FRAMES) {
+        baselineSharpness = delays.sharpness;
+    }
+    
+    analyzeSpectra(delays, baselineBandRatioDb);
+    hasSpectralBaseline = delays.spectralFrames >= MIN_SPECTRAL_FRAMES;
     
     Serial.print("Baseline correlation: ");
     Serial.print(baselineCorrelation * 100 / 256);
     Serial.println("%");
+    Serial.print("Baseline GCC sharpness: ");
+    Serial.print(baselineSharpness * 100 / 256);
+    Serial.println("%");
     
     // Auto-adjust if baseline is very low
     if (baselineCorrelation < 128) { // Less than 50%
@@ -22,20 +58,23 @@ void LaserAttackDetector::calibrate(int16_t* buf1, int16_t* buf2, size_t bufferS
     }
 }
 
-LaserAttackDetector::DetectionResult LaserAttackDetector::detectAttack(
-    int16_t* pitchBuffer1, 
-    int16_t* pitchBuffer2, 
-    size_t bufferSize) {
+const LaserAttackDetector::DetectionResult& LaserAttackDetector::getResult() {
+    uint32_t generation = spectra ? spectra->getGeneration() : 0;
+    if (resultValid && cachedLength == engine.getLength() && cachedSpectraGeneration == generation) {
+        return cachedResult;
+    }
     
-    DetectionResult result = {false, 0, 0, 0, 255};
+    DetectionResult result = {false, 0, 0, 0, 255, 0, 0, 0, 0, 0, 0, 0};
     
-    // 1. Calculate global correlation
-    result.globalCorr = calculateCorrelationQ8(pitchBuffer1, pitchBuffer2, bufferSize);
+    // 1. Global correlation straight from the running moments
+    result.globalCorr = engine.correlationQ8(0, engine.getLength());
+    analyzeDelays(result);
+    bool delayEvidence = result.voicedFrames >= MIN_VOICED_FRAMES;
+    analyzeSpectra(result, nullptr);
+    bool spectralEvidence = result.spectralFrames >= MIN_SPECTRAL_FRAMES;
     
-    // 2. Sliding window analysis
-    int windows = 0;
+    // 2. Sliding window analysis (correlations already computed during capture)
     int anomalousWindows = 0;
-    int32_t sumCorr = 0;
     
     // ADAPTIVE THRESHOLD based on calibration
     int16_t adaptiveThreshold = THRESHOLD_Q8;
@@ -45,27 +84,18 @@ LaserAttackDetector::DetectionResult LaserAttackDetector::detectAttack(
         if (adaptiveThreshold < 51) adaptiveThreshold = 51; // Min 0.2
     }
     
-    for (size_t i = 0; i <= bufferSize - WINDOW_SIZE; i += STRIDE) {
-        int16_t windowCorr = calculateCorrelationQ8(
-            &pitchBuffer1[i], 
-            &pitchBuffer2[i], 
-            WINDOW_SIZE
-        );
-        
-        sumCorr += windowCorr;
-        windows++;
-        
+    for (int w = 0; w < windows; w++) {
         // Use adaptive threshold
-        if (windowCorr < adaptiveThreshold) {
+        if (windowCorr[w] < adaptiveThreshold) {
             anomalousWindows++;
         }
         
-        if (windowCorr < result.minWindowCorr) {
-            result.minWindowCorr = windowCorr;
+        if (windowCorr[w] < result.minWindowCorr) {
+            result.minWindowCorr = windowCorr[w];
         }
     }
     
-    result.anomalyRatio = (anomalousWindows * 100) / windows;
+    result.anomalyRatio = windows > 0 ? (anomalousWindows * 100) / windows : 0;
     
     // 3. ADJUSTED Detection Logic for the hardware
     
@@ -89,6 +119,22 @@ LaserAttackDetector::DetectionResult LaserAttackDetector::detectAttack(
             result.attackDetected = true;
             result.confidence = 50;
         }
+        // Or if the mics disagree on where the sound came from
+        else if (delayEvidence &&
+                 result.sharpness < (baselineSharpness ? baselineSharpness / 2 : SHARPNESS_THRESH) &&
+                 result.tdoaConsistency < CONSISTENCY_THRESH) {
+            result.attackDetected = true;
+            result.confidence = 100 - result.tdoaConsistency;
+        }
+        // Or if the mics' spectra stopped moving together
+        else if (spectralEvidence && result.coherence < COHERENCE_THRESH) {
+            result.attackDetected = true;
+            result.confidence = 100 - (result.coherence * 100 / 255);
+        }
+        else if (spectralEvidence && hasSpectralBaseline && result.bandRatioDev > BAND_RATIO_DEV_DB) {
+            result.attackDetected = true;
+            result.confidence = 60;
+        }
     } else {
         // Fallback: Use fixed thresholds but much more lenient
         if (result.globalCorr < GLOBAL_THRESH) { // 0.3
@@ -99,6 +145,16 @@ LaserAttackDetector::DetectionResult LaserAttackDetector::detectAttack(
             result.attackDetected = true;
             result.confidence = result.anomalyRatio / 2;
         }
+        else if (delayEvidence &&
+                 result.sharpness < SHARPNESS_THRESH &&
+                 result.tdoaConsistency < CONSISTENCY_THRESH) {
+            result.attackDetected = true;
+            result.confidence = (100 - result.tdoaConsistency) / 2;
+        }
+        else if (spectralEvidence && result.coherence < COHERENCE_THRESH) {
+            result.attackDetected = true;
+            result.confidence = (100 - (result.coherence * 100 / 255)) / 2;
+        }
     }
     
     // Boost confidence only for extreme cases
@@ -106,50 +162,145 @@ LaserAttackDetector::DetectionResult LaserAttackDetector::detectAttack(
         result.confidence = 100;
     }
     
-    return result;
+    cachedResult = result;
+    cachedLength = engine.getLength();
+    cachedSpectraGeneration = generation;
+    resultValid = true;
+    return cachedResult;
 }
 
-// IMPROVED correlation calculation with DC removal
-int16_t LaserAttackDetector::calculateCorrelationQ8(int16_t* buf1, int16_t* buf2, int size) {
-    // First pass: calculate means (DC offset)
-    int32_t mean1 = 0, mean2 = 0;
-    for (int i = 0; i < size; i++) {
-        mean1 += buf1[i];
-        mean2 += buf2[i];
-    }
-    mean1 /= size;
-    mean2 /= size;
-    
-    // Second pass: calculate correlation with DC removed
-    int64_t sum11 = 0, sum22 = 0, sum12 = 0;
-    
-    for (int i = 0; i < size; i++) {
-        int32_t v1 = buf1[i] - mean1;  // Remove DC
-        int32_t v2 = buf2[i] - mean2;  // Remove DC
+void LaserAttackDetector::analyzeDelays(DetectionResult& result) {
+    result.tdoa = 0;
+    result.tdoaConsistency = 0;
+    result.sharpness = 0;
+    result.voicedFrames = 0;
+    
+    size_t length = engine.getLength();
+    if (length < WINDOW_SIZE) return;
+    
+    // Only windows with at least a quarter of the average energy carry a
+    // usable delay; silence just yields a random peak
+    CorrelationEngine::Moments all = engine.moments(0, length);
+    int64_t globalVar = ((int64_t)length * all.sxx - all.sx * all.sx) / ((int64_t)length * length);
+    
+    int histogram[2 * GccPhat::MAX_LAG + 1] = {0};
+    uint32_t sharpnessSum = 0;
+    int voiced = 0;
+    
+    for (size_t start = 0; start + WINDOW_SIZE <= length; start += STRIDE) {
+        CorrelationEngine::Moments m = engine.moments(start, WINDOW_SIZE);
+        int64_t var = ((int64_t)WINDOW_SIZE * m.sxx - m.sx * m.sx) / ((int64_t)WINDOW_SIZE * WINDOW_SIZE);
+        if (var * 4 < globalVar) continue;
         
-        sum11 += v1 * v1;
-        sum22 += v2 * v2;
-        sum12 += v1 * v2;
+        // One FFT frame from the middle of the window, split into planar
+        size_t frame = start + (WINDOW_SIZE - GccPhat::FRAME_SIZE) / 2;
+        capture->copyChannels(frame, GccPhat::FRAME_SIZE, gccFrame1, gccFrame2);
+        GccPhat::Estimate e = gcc.estimate(gccFrame1, gccFrame2);
+        
+        histogram[e.tdoa + GccPhat::MAX_LAG]++;
+        sharpnessSum += e.sharpness;
+        voiced++;
+    }
+    
+    if (voiced == 0) return;
+    
+    int mode = 0;
+    for (int i = 1; i <= 2 * GccPhat::MAX_LAG; i++) {
+        if (histogram[i] > histogram[mode]) mode = i;
     }
     
-    // Avoid division by zero
-    if (sum11 <= 0 || sum22 <= 0) {
-        return 0;
+    int agreeing = histogram[mode];
+    if (mode > 0) agreeing += histogram[mode - 1];
+    if (mode < 2 * GccPhat::MAX_LAG) agreeing += histogram[mode + 1];
+    
+    result.tdoa = mode - GccPhat::MAX_LAG;
+    result.tdoaConsistency = (agreeing * 100) / voiced;
+    result.sharpness = sharpnessSum / voiced;
+    result.voicedFrames = voiced > 255 ? 255 : voiced;
+}
+
+bool LaserAttackDetector::spectraFresh() {
+    // Only spectra published after this capture started describe it
+    return spectra && spectra->getGeneration() != spectraGenerationAtCapture;
+}
+
+void LaserAttackDetector::analyzeSpectra(DetectionResult& result, float* bandRatioDb) {
+    result.coherence = 0;
+    result.bandRatioDev = 0;
+    result.spectralFrames = 0;
+    
+    const int bands = SpectralFrameStore::BANDS;
+    if (bandRatioDb) {
+        for (int b = 0; b < bands; b++) bandRatioDb[b] = 0.0f;
+    }
+    
+    if (!spectraFresh()) return;
+    
+    int frames = spectra->getFrameCount();
+    if (frames == 0) return;
+    
+    // Skip quiet frames, same rule as the delay analysis
+    float meanEnergy = 0.0f;
+    for (int f = 0; f < frames; f++) {
+        const SpectralFrameStore::Frame& frame = spectra->getFrame(f);
+        for (int b = 0; b < bands; b++) meanEnergy += frame.energy1[b];
+    }
+    meanEnergy /= frames;
+    
+    float e1[bands] = {0}, e2[bands] = {0}, cr[bands] = {0}, ci[bands] = {0};
+    int used = 0;
+    
+    for (int f = 0; f < frames; f++) {
+        const SpectralFrameStore::Frame& frame = spectra->getFrame(f);
+        float energy = 0.0f;
+        for (int b = 0; b < bands; b++) energy += frame.energy1[b];
+        if (energy * 4 < meanEnergy) continue;
+        
+        for (int b = 0; b < bands; b++) {
+            e1[b] += frame.energy1[b];
+            e2[b] += frame.energy2[b];
+            cr[b] += frame.crossRe[b];
+            ci[b] += frame.crossIm[b];
+        }
+        used++;
     }
     
-    // Simple integer square root approximation
-    // sqrt(a*b) ≈ (a+b)/2 when a≈b
-    int64_t denomApprox = (sum11 + sum22) / 2;
-    if (denomApprox == 0) return 0;
+    if (used == 0) return;
+    
+    // Magnitude-squared coherence per band, averaged; level ratio in dB
+    float coherenceSum = 0.0f;
+    float worstDev = 0.0f;
+    int validBands = 0;
     
-    // Calculate correlation in Q8 format
-    int16_t correlation = (sum12 * 256) / denomApprox;
+    for (int b = 0; b < bands; b++) {
+        if (e1[b] <= 0.0f || e2[b] <= 0.0f) continue;
+        
+        coherenceSum += (cr[b] * cr[b] + ci[b] * ci[b]) / (e1[b] * e2[b]);
+        validBands++;
+        
+        float ratioDb = 10.0f * log10f(e2[b] / e1[b]);
+        if (bandRatioDb) bandRatioDb[b] = ratioDb;
+        
+        if (hasSpectralBaseline) {
+            float dev = fabsf(ratioDb - baselineBandRatioDb[b]);
+            if (dev > worstDev) worstDev = dev;
+        }
+    }
     
-    // Clamp to valid range
-    if (correlation > 256) correlation = 256;
-    if (correlation < 0) correlation = 0;  // Use 0 instead of abs()
+    if (validBands == 0) return;
     
-    return correlation;
+    result.coherence = (uint8_t)(255.0f * coherenceSum / validBands);
+    result.bandRatioDev = worstDev > 255.0f ? 255 : (uint8_t)worstDev;
+    result.spectralFrames = used > 255 ? 255 : used;
+}
+
+size_t LaserAttackDetector::gcd(size_t a, size_t b) {
+    while (b) {
+        size_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
 }
 
 void LaserAttackDetector::printResults(const DetectionResult& result) {
@@ -177,6 +328,26 @@ void LaserAttackDetector::printResults(const DetectionResult& result) {
     Serial.print(result.minWindowCorr * 100 / 256);
     Serial.println("%");
     
+    Serial.print("Mic delay (TDOA): ");
+    Serial.print(result.tdoa);
+    Serial.print(" samples, ");
+    Serial.print(result.tdoaConsistency);
+    Serial.print("% consistent over ");
+    Serial.print(result.voicedFrames);
+    Serial.println(" frames");
+    
+    Serial.print("GCC-PHAT sharpness: ");
+    Serial.print(result.sharpness * 100 / 256);
+    Serial.println("%");
+    
+    if (result.spectralFrames > 0) {
+        Serial.print("Spectral coherence: ");
+        Serial.print(result.coherence * 100 / 255);
+        Serial.print("%, band shift ");
+        Serial.print(result.bandRatioDev);
+        Serial.println(" dB");
+    }
+    
     if (result.attackDetected) {
         Serial.println("\n⚠️  ATTACK DETECTED!");
         Serial.print("Confidence: ");
@@ -0,0 +1,35 @@
+// ============================================================================
+// LcdFrameBuffer.cpp - Shadow framebuffer for HD44780 character LCDs
+// ============================================================================
+#include <string.h>
+#include "LcdFrameBuffer.h"
+
+LcdFrameBuffer::LcdFrameBuffer() : dirty(0), busWrites(0) {
+    invalidate();
+}
+
+void LcdFrameBuffer::invalidate() {
+    memset(shown, ' ', sizeof(shown));
+    memset(pending, ' ', sizeof(pending));
+    dirty = 0;
+}
+
+void LcdFrameBuffer::write(int row, int col, const char* text, int width) {
+    if (row < 0 || row >= ROWS || col < 0) return;
+    if (col + width > COLS) width = COLS - col;
+
+    bool ended = false;
+    for (int i = 0; i < width; i++) {
+        if (!ended && text[i] == '\0') ended = true;
+        char c = ended ? ' ' : text[i];
+        int x = col + i;
+
+        pending[row][x] = c;
+        uint32_t bit = 1UL << (row * COLS + x);
+        if (c != shown[row][x]) {
+            dirty |= bit;
+        } else {
+            dirty &= ~bit;
+        }
+    }
+}
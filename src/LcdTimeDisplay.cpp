@@ -2,8 +2,6 @@
 // LcdTimeDisplay.cpp
 // ============================================================================
 #include <Arduino.h>
-#include <WiFi.h>
-#include <WiFiClientSecure.h>
 #include "LcdTimeDisplay.h"
 
 
@@ -26,138 +24,97 @@ const char* LcdTimeDisplay::STATUS_SET_REMINDER = "Set Reminder";
 
 LcdTimeDisplay::LcdTimeDisplay() {
     lcd = nullptr;
-    ntpUDP = nullptr;
-    timeClient = nullptr;
-    lastTimeUpdate = 0;
+    clockSource = nullptr;
     lastLcdUpdate = 0;
-    currentStatus = "";
 }
 
 LcdTimeDisplay::~LcdTimeDisplay() {
-    if (timeClient) {
-        timeClient->end();
-        delete timeClient;
-    }
-    if (ntpUDP) delete ntpUDP;
     if (lcd) delete lcd;
 }
 
-void LcdTimeDisplay::begin() {
+void LcdTimeDisplay::begin(TimeService* clockSource) {
+    this->clockSource = clockSource;
+    
     // Initialize LCD
     lcd = new LiquidCrystal(LCD_RS, LCD_EN, LCD_D4, LCD_D5, LCD_D6, LCD_D7);
     lcd->begin(LCD_COLS, LCD_ROWS);
     
     // Clear and show welcome
     displayWelcomeMessage();
-    
-    // Initialize NTP Client
-    ntpUDP = new WiFiUDP();
-    timeClient = new NTPClient(*ntpUDP, NTP_SERVER, UTC_OFFSET_SEC);
 }
 
 void LcdTimeDisplay::displayWelcomeMessage() {
-    lcd->clear();
-    lcd->setCursor(0, 0);
-    lcd->print("Voice Assistant");
-    lcd->setCursor(0, 1);
-    lcd->print("Initializing...");
-    delay(2000);
+    clearDisplay();
+    frameBuffer.writeLine(0, "Voice Assistant");
+    frameBuffer.writeLine(1, "Initializing...");
+    frameBuffer.flush(*lcd);
 }
 
 void LcdTimeDisplay::clearDisplay() {
     lcd->clear();
+    frameBuffer.invalidate();
 }
 
 void LcdTimeDisplay::updateStatus(const char* status) {
-    if (currentStatus != status) {
-        currentStatus = status;
-        
-        // Clear first row and update status
-        lcd->setCursor(0, 0);
-        lcd->print("                "); // Clear the row
-        lcd->setCursor(0, 0);
-        
-        // Truncate status if too long
-        String displayStatus = String(status);
-        if (displayStatus.length() > LCD_COLS) {
-            displayStatus = displayStatus.substring(0, LCD_COLS);
-        }
-        lcd->print(displayStatus);
-    }
+    // Pads/truncates to the row width; only changed cells reach the bus
+    frameBuffer.writeLine(0, status);
+    frameBuffer.flush(*lcd);
 }
 
 void LcdTimeDisplay::forceTimeSync() {
-    if (WiFi.status() == WL_CONNECTED) {
-        if (!timeClient->isTimeSet()) {
-            timeClient->begin();
-        }
-        timeClient->forceUpdate();
-        Serial.println("NTP Time synchronized");
+    // Reply is handled asynchronously by TimeService::loop()
+    if (clockSource) {
+        clockSource->requestSync();
     }
 }
 
+// Format: "Mon 12:34:56 PM" into a 16-cell row, no heap or printf
+void LcdTimeDisplay::formatClock(char* out, int hours, int minutes, int seconds, int day) {
+    static const char days[] = "SunMonTueWedThuFriSat";
+    
+    // Convert to 12-hour format
+    bool isPM = hours >= 12;
+    if (hours > 12) hours -= 12;
+    if (hours == 0) hours = 12;  // Midnight case
+    
+    memcpy(out, &days[day * 3], 3);
+    out[3] = ' ';
+    out[4] = hours >= 10 ? '1' : ' ';
+    out[5] = '0' + hours % 10;
+    out[6] = ':';
+    out[7] = '0' + minutes / 10;
+    out[8] = '0' + minutes % 10;
+    out[9] = ':';
+    out[10] = '0' + seconds / 10;
+    out[11] = '0' + seconds % 10;
+    out[12] = ' ';
+    out[13] = isPM ? 'P' : 'A';
+    out[14] = 'M';
+    out[15] = ' ';
+    out[16] = '\0';
+}
+
 void LcdTimeDisplay::updateTime() {
     unsigned long currentMillis = millis();
     
-    // Update NTP time periodically
-    if (currentMillis - lastTimeUpdate >= NTP_UPDATE_INTERVAL) {
-        if (WiFi.status() == WL_CONNECTED && timeClient) {
-            timeClient->update();
-            lastTimeUpdate = currentMillis;
-        }
-    }
-    
     // Update LCD display every second
     if (currentMillis - lastLcdUpdate >= TIME_UPDATE_INTERVAL) {
         lastLcdUpdate = currentMillis;
         
-        if (WiFi.status() == WL_CONNECTED && timeClient && timeClient->isTimeSet()) {
-            // Get hours, minutes, seconds
-            int hours = timeClient->getHours();
-            int minutes = timeClient->getMinutes();
-            int seconds = timeClient->getSeconds();
-            
-            // Get day of week
-            int day = timeClient->getDay();
-            const char* days[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
-            
-            // Convert to 12-hour format
-            bool isPM = false;
-            if (hours >= 12) {
-                isPM = true;
-                if (hours > 12) {
-                    hours -= 12;
-                }
-            }
-            if (hours == 0) {
-                hours = 12;  // Midnight case
-            }
+        // Local clock keeps running through WiFi outages
+        if (clockSource && clockSource->isTimeSet()) {
+            int hours, minutes, seconds, day;
+            clockSource->getLocalTime(hours, minutes, seconds, day);
             
-            // Format time string with leading zeros
-            char timeBuffer[12];
-            sprintf(timeBuffer, "%2d:%02d:%02d %s", 
-                    hours, minutes, seconds, 
-                    isPM ? "PM" : "AM");
-            
-            // Format: "Mon 12:34:56 PM"
-            String displayTime = String(days[day]) + " " + String(timeBuffer);
-            
-            // Update second row with time
-            lcd->setCursor(0, 1);
-            lcd->print("                "); // Clear the row
-            lcd->setCursor(0, 1);
-            
-            // Center the time display if it's shorter than LCD width
-            int padding = (LCD_COLS - displayTime.length()) / 2;
-            if (padding > 0) {
-                lcd->setCursor(padding, 1);
-            }
-            
-            lcd->print(displayTime);
+            char timeRow[LCD_COLS + 1];
+            formatClock(timeRow, hours, minutes, seconds, day);
+            frameBuffer.writeLine(1, timeRow);
         } else {
             // Show waiting for time sync
-            lcd->setCursor(0, 1);
-            lcd->print("Time: Syncing...");
+            frameBuffer.writeLine(1, "Time: Syncing...");
         }
+        
+        // Typically only the seconds digits (1-2 cells) actually change
+        frameBuffer.flush(*lcd);
     }
-}
\ No newline at end of file
+}
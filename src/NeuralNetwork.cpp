@@ -3,6 +3,9 @@
 // ============================================================================
 #include "NeuralNetwork.h"
 #include "happy_model.h"
+#include "StreamingCnn.h"
+#include "WorkerPool.h"
+#include "ParallelConv.h"
 #include "tensorflow/lite/micro/micro_mutable_op_resolver.h"
 #include "tensorflow/lite/micro/micro_error_reporter.h"
 #include "tensorflow/lite/micro/micro_interpreter.h"
@@ -12,7 +15,17 @@
 // Larger arena for CNN model
 const int kArenaSize = 20000;
 
+// Core 0 below the wake and UI tasks: the helper only gets the time they
+// leave while blocked on the ADC or their queues, so it never delays the
+// capture or the features. The caller on core 1 takes the rows it misses;
+// a row the helper was preempted in holds the barrier, with the caller
+// asleep rather than spinning, until core 0 frees up.
+const int kConvHelperCore = 0;
+const int kConvHelperPriority = tskIDLE_PRIORITY;
+
 NeuralNetwork::NeuralNetwork() {
+    m_streaming = nullptr;
+    m_workers = nullptr;
     m_error_reporter = new tflite::MicroErrorReporter();
 
     m_tensor_arena = (uint8_t *)malloc(kArenaSize);
@@ -28,9 +41,32 @@ NeuralNetwork::NeuralNetwork() {
         return;
     }
     
+    // Convolution rows are shared with a helper on core 0, by the streaming
+    // pass and by full interpreter passes alike
+    m_workers = new WorkerPool();
+    if (!m_workers->begin(1, kConvHelperCore, kConvHelperPriority)) {
+        delete m_workers;
+        m_workers = nullptr;
+    }
+
+    // Sliding windows reuse the layers' earlier columns when the model allows
+    m_streaming = new StreamingCnn();
+    if (m_streaming->begin(m_model)) {
+        m_streaming->setWorkers(m_workers);
+        TF_LITE_REPORT_ERROR(m_error_reporter, "Streaming inference enabled\n");
+    } else {
+        TF_LITE_REPORT_ERROR(m_error_reporter, "Model layout not streamable, using full passes\n");
+        delete m_streaming;
+        m_streaming = nullptr;
+    }
+
     // Add operations needed for CNN
     m_resolver = new tflite::MicroMutableOpResolver<10>();
-    m_resolver->AddConv2D();
+    if (m_workers) {
+        m_resolver->AddConv2D(Register_PARALLEL_CONV_2D(m_workers));
+    } else {
+        m_resolver->AddConv2D();
+    }
     m_resolver->AddMaxPool2D();
     m_resolver->AddFullyConnected();
     m_resolver->AddLogistic();  // Sigmoid activation
@@ -70,8 +106,10 @@ NeuralNetwork::NeuralNetwork() {
 }
 
 NeuralNetwork::~NeuralNetwork() {
+    delete m_streaming;
     delete m_interpreter;
     delete m_resolver;
+    delete m_workers;
     free(m_tensor_arena);
     delete m_error_reporter;
 }
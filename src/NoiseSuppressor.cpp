@@ -0,0 +1,147 @@
+// ============================================================================
+// NoiseSuppressor.cpp - Wiener noise suppression in the STFT domain
+// ============================================================================
+#include "NoiseSuppressor.h"
+
+NoiseSuppressor::NoiseSuppressor() {
+    // Periodic sqrt-Hann: analysis * synthesis windows at 50% overlap sum to 1
+    for (int i = 0; i < FRAME_SIZE; i++) {
+        window[i] = sqrt(0.5 * (1.0 - cos(2.0 * PI * i / FRAME_SIZE)));
+    }
+    reset();
+}
+
+void NoiseSuppressor::reset() {
+    primed = false;
+    for (int i = 0; i < FFT_BINS; i++) {
+        noise[i] = 0.0f;
+        cleanPower[i] = 0.0f;
+        gain[i] = 1.0f;
+    }
+    frames = 0;
+    lastFrameMicros = 0;
+    maxFrameMicros = 0;
+    restart();
+}
+
+void NoiseSuppressor::restart() {
+    memset(input, 0, sizeof(input));
+    memset(overlap, 0, sizeof(overlap));
+    memset(output, 0, sizeof(output));
+    filled = 0;
+    leadIn = true;
+}
+
+void NoiseSuppressor::suppress(float* power) {
+    if (!primed) {
+        // First frame seeds the floor; the fast fall corrects it if speech
+        // was already present
+        for (int i = 0; i < FFT_BINS; i++) {
+            noise[i] = power[i];
+            cleanPower[i] = 0.0f;
+        }
+        primed = true;
+    }
+
+    for (int i = 0; i < FFT_BINS; i++) {
+        float p = power[i];
+        float n = noise[i];
+        n += (p - n) * (p < n ? NOISE_FALL : NOISE_RISE);
+        if (n < 1e-3f) n = 1e-3f;
+        noise[i] = n;
+
+        // A-priori SNR: last frame's cleaned power blended with this
+        // frame's excess over the floor
+        float posterior = p / n - 1.0f;
+        if (posterior < 0.0f) posterior = 0.0f;
+        float prior = PRIOR_WEIGHT * cleanPower[i] / n + (1.0f - PRIOR_WEIGHT) * posterior;
+
+        float g = prior / (1.0f + prior);
+        if (g < GAIN_FLOOR) g = GAIN_FLOOR;
+        gain[i] = g;
+
+        power[i] = p * g * g;
+        cleanPower[i] = power[i];
+    }
+}
+
+void NoiseSuppressor::processFrame() {
+    uint32_t start = micros();
+    const int n = FRAME_SIZE;
+
+    for (int i = 0; i < n; i++) {
+        re[i] = input[i] * window[i];
+        im[i] = 0.0f;
+    }
+    AudioProcessor::computeFFT(re, im, n);
+
+    float power[FFT_BINS];
+    for (int k = 0; k < FFT_BINS; k++) {
+        power[k] = re[k] * re[k] + im[k] * im[k];
+    }
+    suppress(power);
+
+    // Real gains keep the spectrum Hermitian. Conjugating it lets the
+    // forward FFT act as the inverse (the result is real, so no conjugate
+    // is needed afterwards).
+    for (int k = 0; k < FFT_BINS; k++) {
+        float g = gain[k];
+        re[k] *= g;
+        im[k] = -im[k] * g;
+        int m = (n - k) & (n - 1);
+        if (m != k) {
+            re[m] = re[k];
+            im[m] = -im[k];
+        }
+    }
+    AudioProcessor::computeFFT(re, im, n);
+
+    // Overlap-add; the first HOP samples have now seen both their frames
+    const float scale = 1.0f / n;
+    for (int i = 0; i < n; i++) {
+        overlap[i] += re[i] * scale * window[i];
+    }
+    for (int i = 0; i < HOP; i++) {
+        float s = overlap[i];
+        if (s > 32767.0f) s = 32767.0f;
+        if (s < -32768.0f) s = -32768.0f;
+        output[i] = (int16_t)lroundf(s);
+    }
+    memmove(overlap, overlap + HOP, (n - HOP) * sizeof(float));
+    memset(overlap + n - HOP, 0, HOP * sizeof(float));
+
+    frames++;
+    lastFrameMicros = micros() - start;
+    if (lastFrameMicros > maxFrameMicros) maxFrameMicros = lastFrameMicros;
+}
+
+void NoiseSuppressor::process(int16_t* samples, int count) {
+    for (int i = 0; i < count; i++) {
+        // The last HOP input slots fill while the previous frame's output drains
+        int16_t in = samples[i];
+        samples[i] = output[filled];
+        input[FRAME_SIZE - HOP + filled] = in;
+
+        if (++filled == HOP) {
+            // The stream's first frame would open on FRAME_SIZE - HOP zeros,
+            // a step the noise floor would be seeded from. Mirroring the
+            // first samples into that slot keeps the frame continuous.
+            if (leadIn) {
+                for (int j = 0; j < FRAME_SIZE - HOP; j++) {
+                    input[j] = input[2 * (FRAME_SIZE - HOP) - 1 - j];
+                }
+                leadIn = false;
+            }
+            processFrame();
+            memmove(input, input + HOP, (FRAME_SIZE - HOP) * sizeof(float));
+            filled = 0;
+        }
+    }
+}
+
+int NoiseSuppressor::flush(int16_t* tail) {
+    // Silence after the end completes the last frames' overlap-add
+    memset(tail, 0, LATENCY * sizeof(int16_t));
+    process(tail, LATENCY);
+    return LATENCY;
+}
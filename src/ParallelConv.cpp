@@ -0,0 +1,120 @@
+// ============================================================================
+// ParallelConv.cpp - Float Conv2D kernel split by output rows across a pool
+// ============================================================================
+#include "ParallelConv.h"
+#include "tensorflow/lite/c/builtin_op_data.h"
+#include "tensorflow/lite/c/common.h"
+#include "tensorflow/lite/kernels/internal/reference/conv.h"
+#include "tensorflow/lite/kernels/kernel_util.h"
+#include "tensorflow/lite/kernels/padding.h"
+#include "tensorflow/lite/micro/kernels/kernel_util.h"
+#include "tensorflow/lite/micro/kernels/micro_ops.h"
+
+namespace {
+
+const int kInputTensor = 0;
+const int kFilterTensor = 1;
+const int kBiasTensor = 2;
+const int kOutputTensor = 0;
+
+WorkerPool* pool = nullptr;
+TfLiteRegistration stock;
+
+// One float convolution, shared read-only by every row
+struct ConvJob {
+    tflite::ConvParams params;
+    int outHeight;
+    int inRowSize;                  // Floats per input batch
+    int outRowSize;                 // Floats per output row
+    tflite::RuntimeShape inputShape;    // Batch of 1
+    tflite::RuntimeShape filterShape;
+    tflite::RuntimeShape biasShape;
+    tflite::RuntimeShape rowShape;      // 1 x 1 x width x channels
+    const float* input;
+    const float* filter;
+    const float* bias;
+    float* output;
+};
+
+// Item = batch * outHeight + row. Shifting the padding by the row's origin
+// makes the reference loop's only row compute what its out_y would have.
+void convRow(void* context, int item) {
+    const ConvJob& job = *static_cast<const ConvJob*>(context);
+    int batch = item / job.outHeight;
+    int row = item % job.outHeight;
+
+    tflite::ConvParams params = job.params;
+    params.padding_values.height -= row * params.stride_height;
+
+    tflite::reference_ops::Conv(params, job.inputShape, job.input + batch * job.inRowSize,
+                                job.filterShape, job.filter, job.biasShape, job.bias,
+                                job.rowShape, job.output + item * job.outRowSize,
+                                tflite::RuntimeShape(), nullptr);
+}
+
+TfLiteStatus eval(TfLiteContext* context, TfLiteNode* node) {
+    const TfLiteEvalTensor* input = tflite::micro::GetEvalInput(context, node, kInputTensor);
+    if (!pool || input->type != kTfLiteFloat32) return stock.invoke(context, node);
+
+    const TfLiteEvalTensor* filter = tflite::micro::GetEvalInput(context, node, kFilterTensor);
+    const TfLiteEvalTensor* bias = tflite::NumInputs(node) == 3
+        ? tflite::micro::GetEvalInput(context, node, kBiasTensor) : nullptr;
+    TfLiteEvalTensor* output = tflite::micro::GetEvalOutput(context, node, kOutputTensor);
+    const auto* options = static_cast<const TfLiteConvParams*>(node->builtin_data);
+
+    tflite::RuntimeShape inputShape = tflite::micro::GetTensorShape(input);
+    tflite::RuntimeShape filterShape = tflite::micro::GetTensorShape(filter);
+    tflite::RuntimeShape outputShape = tflite::micro::GetTensorShape(output);
+    int batches = inputShape.Dims(0);
+    int outHeight = outputShape.Dims(1);
+    int outWidth = outputShape.Dims(2);
+
+    // Same parameters the stock kernel derives in prepare and eval
+    int paddedHeight, paddedWidth;
+    TfLitePaddingValues padding = tflite::ComputePaddingHeightWidth(
+        options->stride_height, options->stride_width,
+        options->dilation_height_factor, options->dilation_width_factor,
+        inputShape.Dims(1), inputShape.Dims(2), filterShape.Dims(1), filterShape.Dims(2),
+        options->padding, &paddedHeight, &paddedWidth);
+
+    ConvJob job;
+    job.params.padding_type = options->padding == kTfLitePaddingSame
+        ? tflite::PaddingType::kSame : tflite::PaddingType::kValid;
+    job.params.padding_values.width = padding.width;
+    job.params.padding_values.height = padding.height;
+    job.params.stride_width = options->stride_width;
+    job.params.stride_height = options->stride_height;
+    job.params.dilation_width_factor = options->dilation_width_factor;
+    job.params.dilation_height_factor = options->dilation_height_factor;
+    tflite::CalculateActivationRange(options->activation, &job.params.float_activation_min,
+                                     &job.params.float_activation_max);
+
+    job.outHeight = outHeight;
+    job.inRowSize = inputShape.FlatSize() / batches;
+    job.outRowSize = outWidth * outputShape.Dims(3);
+    job.inputShape.ReplaceWith(4, inputShape.DimsData());
+    job.inputShape.SetDim(0, 1);
+    job.filterShape.ReplaceWith(4, filterShape.DimsData());
+    tflite::RuntimeShape biasShape = tflite::micro::GetTensorShape(bias);
+    job.biasShape.ReplaceWith(biasShape.DimensionsCount(), biasShape.DimsData());
+    int32_t rowDims[4] = {1, 1, outWidth, outputShape.Dims(3)};
+    job.rowShape.ReplaceWith(4, rowDims);
+    job.input = tflite::micro::GetTensorData<float>(input);
+    job.filter = tflite::micro::GetTensorData<float>(filter);
+    job.bias = bias ? tflite::micro::GetTensorData<float>(bias) : nullptr;
+    job.output = tflite::micro::GetTensorData<float>(output);
+
+    pool->run(convRow, &job, batches * outHeight);
+    return kTfLiteOk;
+}
+
+}  // namespace
+
+TfLiteRegistration Register_PARALLEL_CONV_2D(WorkerPool* workers) {
+    pool = workers;
+    stock = tflite::ops::micro::Register_CONV_2D();
+
+    TfLiteRegistration registration = stock;
+    registration.invoke = eval;
+    return registration;
+}
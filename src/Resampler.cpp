@@ -0,0 +1,252 @@
+// ============================================================================
+// Resampler.cpp - Streaming polyphase FIR resampler (Q15, two channels)
+// ============================================================================
+#include "Resampler.h"
+
+bool Resampler::begin(int up, int down, int tapsPerPhase) {
+    if (up < 1 || up > MAX_PHASES || down < 1 ||
+        tapsPerPhase < 2 || tapsPerPhase > MAX_TAPS || (tapsPerPhase & 1)) {
+        Serial.println("[RESAMPLE] ERROR: Unsupported ratio or tap count!");
+        return false;
+    }
+
+    this->up = up;
+    this->down = down;
+    taps = tapsPerPhase;
+    halfBand = (up == 2 && down == 1);
+
+    design();
+    reset();
+    return true;
+}
+
+// Windowed-sinc taps per phase, each normalised to unity DC gain
+void Resampler::design() {
+    // Cut off at the lower of the two Nyquist rates
+    float cutoff = (up >= down) ? 1.0f : (float)up / down;
+    float halfWidth = taps / 2;
+
+    for (int p = 0; p < up; p++) {
+        float mu = (float)p / up;
+        float h[MAX_TAPS];
+        float sum = 0.0f;
+
+        // Output sits mu past sample taps/2 - 1 of the history
+        for (int k = 0; k < taps; k++) {
+            float t = (k - (taps / 2 - 1)) - mu;
+            float x = PI * cutoff * t;
+            float sinc = (fabsf(x) < 1e-6f) ? 1.0f : sinf(x) / x;
+            float window = 0.5f * (1.0f + cosf(PI * t / halfWidth));
+            h[k] = sinc * window;
+            sum += h[k];
+        }
+
+        for (int k = 0; k < taps; k++) {
+            int32_t q = (int32_t)lroundf(h[k] / sum * 32768.0f);
+            if (q > 32767) q = 32767;
+            if (q < -32768) q = -32768;
+            coeffs[p][k] = (int16_t)q;
+        }
+    }
+}
+
+void Resampler::reset() {
+    memset(history1, 0, sizeof(history1));
+    memset(history2, 0, sizeof(history2));
+    position = 0;
+    warmup = taps / 2;
+}
+
+void Resampler::push(int16_t s1, int16_t s2) {
+    for (int k = 0; k < taps - 1; k++) {
+        history1[k] = history1[k + 1];
+        history2[k] = history2[k + 1];
+    }
+    history1[taps - 1] = s1;
+    history2[taps - 1] = s2;
+}
+
+void Resampler::push(int16_t s) {
+    for (int k = 0; k < taps - 1; k++) {
+        history1[k] = history1[k + 1];
+    }
+    history1[taps - 1] = s;
+}
+
+static inline int16_t saturateQ15(int32_t acc) {
+    acc = (acc + (1 << 14)) >> 15;
+    if (acc > 32767) return 32767;
+    if (acc < -32768) return -32768;
+    return (int16_t)acc;
+}
+
+static inline int16_t saturateQ15(int64_t acc) {
+    acc = (acc + (1 << 14)) >> 15;
+    if (acc > 32767) return 32767;
+    if (acc < -32768) return -32768;
+    return (int16_t)acc;
+}
+
+int Resampler::outputLength(int inputLength) const {
+    // Outputs land at n * down / up input samples after the first input,
+    // and each needs taps/2 samples of lookahead
+    long usable = (long)inputLength - taps / 2;
+    if (usable <= 0) return 0;
+    return (int)((usable * up + down - 1) / down);
+}
+
+int16_t Resampler::sampleAt(const int16_t* x, int stride, int inputLength, int n) const {
+    long pos = (long)n * down;
+    int base = pos / up;
+    int phase = pos % up;
+
+    // History window for this output starts taps/2 - 1 samples before base
+    int first = base - (taps / 2 - 1);
+    const int16_t* c = coeffs[phase];
+
+    if (halfBand && phase == 0) {
+        return base < inputLength ? x[base * stride] : 0;
+    }
+
+    if (halfBand && first >= 0 && first + taps <= inputLength) {
+
+        // Same folded 32-bit sum as process()
+        int32_t acc = 0;
+        for (int k = 0; k < taps / 2; k++) {
+            acc += (int32_t)c[k] * (x[(first + k) * stride] + x[(first + taps - 1 - k) * stride]);
+        }
+        return saturateQ15(acc);
+    }
+
+    int64_t acc = 0;
+    if (first >= 0 && first + taps <= inputLength) {
+        const int16_t* p = &x[first * stride];
+        for (int k = 0; k < taps; k++) {
+            acc += (int32_t)c[k] * p[k * stride];
+        }
+    } else {
+        for (int k = 0; k < taps; k++) {
+            int idx = first + k;
+            if (idx >= 0 && idx < inputLength) {
+                acc += (int32_t)c[k] * x[idx * stride];
+            }
+        }
+    }
+    return saturateQ15(acc);
+}
+
+int Resampler::process(const int16_t* in1, const int16_t* in2, int count,
+                       int16_t* out1, int16_t* out2, int maxOut) {
+    int written = 0;
+    const int centre = taps / 2 - 1;
+
+    if (halfBand) {
+        // Even outputs are the input samples themselves; odd outputs use
+        // symmetric taps, so pairs are folded before multiplying
+        const int16_t* c = coeffs[1];
+
+        for (int i = 0; i < count; i++) {
+            push(in1[i], in2[i]);
+
+            if (warmup > 0) {
+                warmup--;
+                continue;
+            }
+            if (written + 2 > maxOut) break;
+
+            int32_t acc1 = 0, acc2 = 0;
+            for (int k = 0; k < taps / 2; k++) {
+                int j = taps - 1 - k;
+                acc1 += (int32_t)c[k] * (history1[k] + history1[j]);
+                acc2 += (int32_t)c[k] * (history2[k] + history2[j]);
+            }
+
+            out1[written] = history1[centre];
+            out2[written] = history2[centre];
+            out1[written + 1] = saturateQ15(acc1);
+            out2[written + 1] = saturateQ15(acc2);
+            written += 2;
+        }
+        return written;
+    }
+
+    for (int i = 0; i < count; i++) {
+        push(in1[i], in2[i]);
+
+        if (warmup > 0) {
+            warmup--;
+            continue;
+        }
+
+        while (position < up) {
+            if (written >= maxOut) return written;
+
+            // Q15 sums can exceed 32 bits with long filters
+            const int16_t* c = coeffs[position];
+            int64_t acc1 = 0, acc2 = 0;
+            for (int k = 0; k < taps; k++) {
+                acc1 += (int32_t)c[k] * history1[k];
+                acc2 += (int32_t)c[k] * history2[k];
+            }
+            out1[written] = saturateQ15(acc1);
+            out2[written] = saturateQ15(acc2);
+
+            written++;
+            position += down;
+        }
+        position -= up;
+    }
+    return written;
+}
+
+int Resampler::process(const int16_t* in, int stride, int count, int16_t* out, int maxOut) {
+    int written = 0;
+    const int centre = taps / 2 - 1;
+
+    if (halfBand) {
+        const int16_t* c = coeffs[1];
+
+        for (int i = 0; i < count; i++) {
+            push(in[i * stride]);
+
+            if (warmup > 0) {
+                warmup--;
+                continue;
+            }
+            if (written + 2 > maxOut) break;
+
+            int32_t acc = 0;
+            for (int k = 0; k < taps / 2; k++) {
+                acc += (int32_t)c[k] * (history1[k] + history1[taps - 1 - k]);
+            }
+
+            out[written] = history1[centre];
+            out[written + 1] = saturateQ15(acc);
+            written += 2;
+        }
+        return written;
+    }
+
+    for (int i = 0; i < count; i++) {
+        push(in[i * stride]);
+
+        if (warmup > 0) {
+            warmup--;
+            continue;
+        }
+
+        while (position < up) {
+            if (written >= maxOut) return written;
+
+            const int16_t* c = coeffs[position];
+            int64_t acc = 0;
+            for (int k = 0; k < taps; k++) {
+                acc += (int32_t)c[k] * history1[k];
+            }
+            out[written++] = saturateQ15(acc);
+            position += down;
+        }
+        position -= up;
+    }
+    return written;
+}
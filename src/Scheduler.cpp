@@ -0,0 +1,90 @@
+// ============================================================================
+// Scheduler.cpp - Cooperative one-shot/periodic timers on a pluggable clock
+// ============================================================================
+#include <Arduino.h>
+#include "Scheduler.h"
+
+static uint32_t defaultClock() {
+    return millis();
+}
+
+Scheduler::Scheduler(ClockFn clock) {
+    memset(timers, 0, sizeof(timers));
+    setClock(clock);
+}
+
+void Scheduler::setClock(ClockFn clock) {
+    this->clock = clock ? clock : defaultClock;
+}
+
+Scheduler::TimerId Scheduler::add(uint32_t delayMs, uint32_t periodMs, bool periodic,
+                                  TimerCallback callback, void* context) {
+    for (int i = 0; i < MAX_TIMERS; i++) {
+        if (!timers[i].active) {
+            timers[i].active = true;
+            timers[i].periodic = periodic;
+            timers[i].due = clock() + delayMs;
+            timers[i].period = periodMs;
+            timers[i].callback = callback;
+            timers[i].context = context;
+            return i;
+        }
+    }
+    Serial.println("[SCHED] ERROR: No free timer slots!");
+    return INVALID_TIMER;
+}
+
+Scheduler::TimerId Scheduler::after(uint32_t delayMs, TimerCallback callback, void* context) {
+    return add(delayMs, 0, false, callback, context);
+}
+
+Scheduler::TimerId Scheduler::every(uint32_t periodMs, TimerCallback callback, void* context) {
+    return add(periodMs, periodMs, true, callback, context);
+}
+
+void Scheduler::cancel(TimerId id) {
+    if (id >= 0 && id < MAX_TIMERS) {
+        timers[id].active = false;
+    }
+}
+
+bool Scheduler::isPending(TimerId id) {
+    return id >= 0 && id < MAX_TIMERS && timers[id].active;
+}
+
+void Scheduler::tick() {
+    uint32_t t = clock();
+
+    // Timers due now run earliest first, so a late tick keeps their order;
+    // any a callback arms wait for the next tick
+    uint32_t ready = 0;
+    for (int i = 0; i < MAX_TIMERS; i++) {
+        if (timers[i].active && (int32_t)(t - timers[i].due) >= 0) ready |= 1UL << i;
+    }
+
+    while (ready) {
+        int next = __builtin_ctz(ready);
+        for (uint32_t bits = ready & (ready - 1); bits; bits &= bits - 1) {
+            int i = __builtin_ctz(bits);
+            if ((int32_t)(timers[i].due - timers[next].due) < 0) next = i;
+        }
+        ready &= ~(1UL << next);
+
+        // An earlier callback may have cancelled or re-armed this slot
+        Timer& timer = timers[next];
+        if (!timer.active || (int32_t)(t - timer.due) < 0) continue;
+
+        if (timer.periodic) {
+            // Keep the phase; skip missed periods instead of bursting
+            timer.due += timer.period;
+            if ((int32_t)(t - timer.due) >= 0) {
+                timer.due = t + timer.period;
+            }
+        } else {
+            timer.active = false;
+        }
+
+        // May cancel or re-arm timers, including this slot
+        timer.callback(timer.context);
+    }
+}
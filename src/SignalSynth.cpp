@@ -0,0 +1,96 @@
+// ============================================================================
+// SignalSynth.cpp - Reproducible test signals (DTMF, noise, laser-style capture)
+// ============================================================================
+#include "SignalSynth.h"
+#include "AudioRecorder.h"
+
+static const float DTMF_LOW[4] = {697, 770, 852, 941};
+static const float DTMF_HIGH[4] = {1209, 1336, 1477, 1633};
+static const char DTMF_KEYS[] = "123A456B789C*0#D";
+
+SignalSynth::SignalSynth(uint32_t seed) {
+    this->seed(seed);
+}
+
+void SignalSynth::seed(uint32_t seed) {
+    state = seed ? seed : 1;
+}
+
+// xorshift32: cheap, and identical on host and device
+float SignalSynth::uniform() {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return (float)(int32_t)state / 2147483648.0f;
+}
+
+float SignalSynth::gaussian(float rms) {
+    // Four uniforms have variance 4/3; rescale to unit variance
+    float sum = uniform() + uniform() + uniform() + uniform();
+    return sum * 0.8660254f * rms;
+}
+
+int16_t SignalSynth::saturate(float x) {
+    if (x > 32767.0f) return 32767;
+    if (x < -32768.0f) return -32768;
+    return (int16_t)lroundf(x);
+}
+
+float SignalSynth::amplitude(float db) {
+    return 32767.0f * powf(10.0f, db / 20.0f);
+}
+
+int SignalSynth::dtmf(const char* keys, const DtmfSpec& spec, int16_t* frames, int capacity) {
+    const int toneFrames = spec.toneMs * SAMPLE_RATE / 1000;
+    const int gapFrames = spec.gapMs * SAMPLE_RATE / 1000;
+    const float low = amplitude(spec.levelDb);
+    const float high = amplitude(spec.levelDb + spec.twistDb);
+    const float noiseRms = sqrtf(0.5f * (low * low + high * high)) / powf(10.0f, spec.snrDb / 20.0f);
+    const float scale = 1.0f + spec.offsetPct / 100.0f;
+
+    int n = 0;
+    for (const char* k = keys; *k; k++) {
+        if (n + toneFrames + gapFrames > capacity) return 0;
+
+        const char* slot = strchr(DTMF_KEYS, *k);
+        int index = slot ? slot - DTMF_KEYS : -1;
+        float w1 = 0.0f, w2 = 0.0f;
+        if (index >= 0) {
+            w1 = 2.0f * PI * DTMF_LOW[index / 4] * scale / SAMPLE_RATE;
+            w2 = 2.0f * PI * DTMF_HIGH[index % 4] * scale / SAMPLE_RATE;
+        }
+
+        for (int i = 0; i < toneFrames + gapFrames; i++, n++) {
+            float tone = 0.0f;
+            if (index >= 0 && i < toneFrames) {
+                tone = low * sinf(w1 * i) + high * sinf(w2 * i);
+            }
+            frames[2 * n] = saturate(tone + gaussian(noiseRms));
+            frames[2 * n + 1] = saturate(tone + gaussian(noiseRms));
+        }
+    }
+    return n;
+}
+
+void SignalSynth::addNoise(int16_t* frames, int count, float rmsDb) {
+    float rms = amplitude(rmsDb);
+    for (int i = 0; i < 2 * count; i++) {
+        frames[i] = saturate(frames[i] + gaussian(rms));
+    }
+}
+
+void SignalSynth::mix(int16_t* frames, int count, const SampleView& source, float gainDb,
+                      int delaySamples, float mic2Gain) {
+    if (source.length == 0) return;
+    float gain = powf(10.0f, gainDb / 20.0f);
+
+    for (int i = 0; i < count; i++) {
+        float s1 = source[i % source.length] * gain;
+        float s2 = 0.0f;
+        if (i >= delaySamples) {
+            s2 = source[(i - delaySamples) % source.length] * gain * mic2Gain;
+        }
+        frames[2 * i] = saturate(frames[2 * i] + s1);
+        frames[2 * i + 1] = saturate(frames[2 * i + 1] + s2);
+    }
+}
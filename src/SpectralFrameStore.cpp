@@ -0,0 +1,27 @@
+// ============================================================================
+// SpectralFrameStore.cpp - Per-frame dual-mic band spectra from the wake features
+// ============================================================================
+#include "SpectralFrameStore.h"
+
+SpectralFrameStore::Frame* SpectralFrameStore::add() {
+    Frame* frame = &frames[next];
+    next = (next + 1) % CAPACITY;
+    written++;
+    memset(frame, 0, sizeof(*frame));
+    return frame;
+}
+
+bool SpectralFrameStore::publish(uint32_t first) {
+    generation++;
+
+    // Unsigned, so a start past the newest frame wraps and fails too
+    uint32_t age = written - first;
+    if (age < N_FRAMES || age > CAPACITY) {
+        frameCount = 0;
+        return false;
+    }
+
+    firstSlot = (next + CAPACITY - (int)age) % CAPACITY;
+    frameCount = N_FRAMES;
+    return true;
+}
@@ -0,0 +1,31 @@
+// ============================================================================
+// StateMachine.cpp - Explicit state objects with enter/tick/exit hooks
+// ============================================================================
+#include <Arduino.h>
+#include "StateMachine.h"
+
+StateMachine::StateMachine() : current(nullptr), pending(nullptr) {
+}
+
+void StateMachine::transitionTo(State* next) {
+    pending = next;
+}
+
+void StateMachine::applyPending() {
+    // enter() may itself request a transition; follow a short chain
+    for (int i = 0; i < MAX_CHAINED_TRANSITIONS && pending; i++) {
+        State* next = pending;
+        pending = nullptr;
+
+        if (current) current->exit();
+        Serial.printf("[STATE] %s -> %s\n", current ? current->name() : "(none)", next->name());
+        current = next;
+        current->enter();
+    }
+}
+
+void StateMachine::tick() {
+    applyPending();
+    if (current) current->tick();
+    applyPending();
+}
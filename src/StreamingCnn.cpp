@@ -0,0 +1,257 @@
+// ============================================================================
+// StreamingCnn.cpp - Wake-word CNN forward pass with per-layer column caches
+// ============================================================================
+#include "StreamingCnn.h"
+#include "WorkerPool.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+
+// Rows [from, to) of a stride-1 SAME conv with a fused ReLU; returns MACs
+static uint32_t convRows(const float* in, int rows, int width, int inC,
+                         const float* weights, const float* bias, int kh, int kw, int outC,
+                         float* out, int from, int to) {
+    uint32_t macs = 0;
+    for (int t = from; t < to; t++) {
+        for (int x = 0; x < width; x++) {
+            float* o = &out[(t * width + x) * outC];
+            for (int k = 0; k < outC; k++) {
+                float acc = bias[k];
+                for (int dy = 0; dy < kh; dy++) {
+                    int ty = t + dy - kh / 2;
+                    if (ty < 0 || ty >= rows) continue;
+                    for (int dx = 0; dx < kw; dx++) {
+                        int tx = x + dx - kw / 2;
+                        if (tx < 0 || tx >= width) continue;
+                        const float* i = &in[(ty * width + tx) * inC];
+                        const float* w = &weights[((k * kh + dy) * kw + dx) * inC];
+                        for (int c = 0; c < inC; c++) acc += i[c] * w[c];
+                        macs += inC;
+                    }
+                }
+                o[k] = acc > 0.0f ? acc : 0.0f;
+            }
+        }
+    }
+    return macs;
+}
+
+// One layer's stale rows, [0, lo) then [hi, rows), as pool items
+struct ConvJob {
+    const float* in;
+    int rows, width, inC;
+    const float* weights;
+    const float* bias;
+    int kh, kw, outC;
+    float* out;
+    int lo, hi;
+    uint32_t macs[N_FRAMES];    // Per item, summed once the pool returns
+};
+
+static void convJobRow(void* context, int item) {
+    ConvJob& job = *static_cast<ConvJob*>(context);
+    int t = item < job.lo ? item : job.hi + item - job.lo;
+    job.macs[item] = convRows(job.in, job.rows, job.width, job.inC, job.weights, job.bias,
+                              job.kh, job.kw, job.outC, job.out, t, t + 1);
+}
+
+// Rows [from, to) of a VALID max pool whose stride equals its size
+static void poolRows(const float* in, int width, int channels, int ph, int pw,
+                     float* out, int from, int to) {
+    int outWidth = width / pw;
+    for (int t = from; t < to; t++) {
+        for (int x = 0; x < outWidth; x++) {
+            for (int c = 0; c < channels; c++) {
+                float m = in[((t * ph) * width + x * pw) * channels + c];
+                for (int dy = 0; dy < ph; dy++) {
+                    for (int dx = 0; dx < pw; dx++) {
+                        float v = in[((t * ph + dy) * width + x * pw + dx) * channels + c];
+                        if (v > m) m = v;
+                    }
+                }
+                out[(t * outWidth + x) * channels + c] = m;
+            }
+        }
+    }
+}
+
+// Drops the oldest rows of a cached layer; the rows freed at the end are
+// always recomputed
+static void shiftRows(float* data, int rows, int rowSize, int by) {
+    if (by <= 0 || by >= rows) return;
+    memmove(data, &data[by * rowSize], (size_t)(rows - by) * rowSize * sizeof(float));
+}
+
+static bool copyTensor(const tflite::Model* model, const tflite::SubGraph* subgraph, int index,
+                       float* out, int count) {
+    const tflite::Tensor* tensor = subgraph->tensors()->Get(index);
+    if (tensor->type() != tflite::TensorType_FLOAT32) return false;
+
+    int elements = 1;
+    for (int i = 0; i < (int)tensor->shape()->size(); i++) elements *= tensor->shape()->Get(i);
+    const flatbuffers::Vector<uint8_t>* data = model->buffers()->Get(tensor->buffer())->data();
+    if (elements != count || !data || data->size() != count * sizeof(float)) return false;
+
+    // The model array has no alignment guarantee, so copy rather than point
+    memcpy(out, data->data(), count * sizeof(float));
+    return true;
+}
+
+static bool isConv(const tflite::Operator* op) {
+    const tflite::Conv2DOptions* options = op->builtin_options_as_Conv2DOptions();
+    return options && options->padding() == tflite::Padding_SAME &&
+           options->stride_w() == 1 && options->stride_h() == 1 &&
+           options->dilation_w_factor() == 1 && options->dilation_h_factor() == 1 &&
+           options->fused_activation_function() == tflite::ActivationFunctionType_RELU;
+}
+
+static bool isPool(const tflite::Operator* op, int ph, int pw) {
+    const tflite::Pool2DOptions* options = op->builtin_options_as_Pool2DOptions();
+    return options && options->padding() == tflite::Padding_VALID &&
+           options->filter_height() == ph && options->stride_h() == ph &&
+           options->filter_width() == pw && options->stride_w() == pw &&
+           options->fused_activation_function() == tflite::ActivationFunctionType_NONE;
+}
+
+bool StreamingCnn::begin(const tflite::Model* model) {
+    static const tflite::BuiltinOperator TOPOLOGY[] = {
+        tflite::BuiltinOperator_CONV_2D, tflite::BuiltinOperator_MAX_POOL_2D,
+        tflite::BuiltinOperator_CONV_2D, tflite::BuiltinOperator_MAX_POOL_2D,
+        tflite::BuiltinOperator_CONV_2D, tflite::BuiltinOperator_MEAN,
+        tflite::BuiltinOperator_FULLY_CONNECTED, tflite::BuiltinOperator_FULLY_CONNECTED,
+        tflite::BuiltinOperator_LOGISTIC,
+    };
+    const int LAYERS = sizeof(TOPOLOGY) / sizeof(TOPOLOGY[0]);
+
+    ready = false;
+    primed = false;
+    if (!model || !model->subgraphs() || model->subgraphs()->size() != 1) return false;
+
+    const tflite::SubGraph* subgraph = model->subgraphs()->Get(0);
+    const auto* ops = subgraph->operators();
+    if (ops->size() != LAYERS) return false;
+    for (int i = 0; i < LAYERS; i++) {
+        const tflite::OperatorCode* code = model->operator_codes()->Get(ops->Get(i)->opcode_index());
+        if (code->builtin_code() != TOPOLOGY[i]) return false;
+    }
+
+    const tflite::Tensor* input = subgraph->tensors()->Get(subgraph->inputs()->Get(0));
+    if (input->shape()->size() != 4 || input->shape()->Get(1) != N_FRAMES ||
+        input->shape()->Get(2) != N_MFCC || input->shape()->Get(3) != 1) {
+        return false;
+    }
+
+    if (!isConv(ops->Get(0)) || !isConv(ops->Get(2)) || !isConv(ops->Get(4))) return false;
+    if (!isPool(ops->Get(1), 2, 1) || !isPool(ops->Get(3), 2, 2)) return false;
+
+    const tflite::FullyConnectedOptions* dense1 = ops->Get(6)->builtin_options_as_FullyConnectedOptions();
+    const tflite::FullyConnectedOptions* dense2 = ops->Get(7)->builtin_options_as_FullyConnectedOptions();
+    if (!dense1 || dense1->fused_activation_function() != tflite::ActivationFunctionType_RELU) return false;
+    if (dense2 && dense2->fused_activation_function() != tflite::ActivationFunctionType_NONE) return false;
+
+    // Filter element counts pin down the kernel sizes and channel counts
+    if (!copyTensor(model, subgraph, ops->Get(0)->inputs()->Get(1), w1, sizeof(w1) / sizeof(float)) ||
+        !copyTensor(model, subgraph, ops->Get(0)->inputs()->Get(2), b1, C1) ||
+        !copyTensor(model, subgraph, ops->Get(2)->inputs()->Get(1), w2, sizeof(w2) / sizeof(float)) ||
+        !copyTensor(model, subgraph, ops->Get(2)->inputs()->Get(2), b2, C2) ||
+        !copyTensor(model, subgraph, ops->Get(4)->inputs()->Get(1), w3, sizeof(w3) / sizeof(float)) ||
+        !copyTensor(model, subgraph, ops->Get(4)->inputs()->Get(2), b3, C3) ||
+        !copyTensor(model, subgraph, ops->Get(6)->inputs()->Get(1), fc1, DENSE * C3) ||
+        !copyTensor(model, subgraph, ops->Get(6)->inputs()->Get(2), fcb1, DENSE) ||
+        !copyTensor(model, subgraph, ops->Get(7)->inputs()->Get(1), fc2, DENSE) ||
+        !copyTensor(model, subgraph, ops->Get(7)->inputs()->Get(2), &fcb2, 1)) {
+        return false;
+    }
+
+    // A full pass, ignoring the few taps that fall on padding
+    fullMacs = T1 * W1 * C1 * K1 * KW * 1 + T2 * W1 * C2 * K2 * KW * C1 + T3 * W3 * C3 * K3 * KW * C2;
+    ready = true;
+    return true;
+}
+
+// Recomputes rows [0, lo) and [hi, rows) of one conv layer, or all of them
+uint32_t StreamingCnn::conv(const float* in, int rows, int width, int inC, const float* weights,
+                            const float* bias, int kh, int outC, float* out, int lo, int hi,
+                            bool full) {
+    if (full || lo >= hi) {
+        lo = rows;
+        hi = rows;
+    }
+
+    if (!workers) {
+        return convRows(in, rows, width, inC, weights, bias, kh, KW, outC, out, 0, lo) +
+               convRows(in, rows, width, inC, weights, bias, kh, KW, outC, out, hi, rows);
+    }
+
+    ConvJob job = {in, rows, width, inC, weights, bias, kh, KW, outC, out, lo, hi};
+    int items = lo + rows - hi;
+    workers->run(convJobRow, &job, items);
+
+    uint32_t macs = 0;
+    for (int i = 0; i < items; i++) macs += job.macs[i];
+    return macs;
+}
+
+float StreamingCnn::predict(const float* features, int newFrames) {
+    bool full = !primed || newFrames >= T1 || newFrames % DECIMATION != 0;
+
+    // Rows [lo, hi) of each layer still hold valid results after the shift
+    int lo = 0, hi = 0;
+    if (!full) {
+        shiftRows(conv1, T1, W1 * C1, newFrames);
+        shiftRows(pool1, T2, W1 * C1, newFrames / 2);
+        shiftRows(conv2, T2, W1 * C2, newFrames / 2);
+        shiftRows(pool2, T3, W3 * C2, newFrames / 4);
+        shiftRows(conv3, T3, W3 * C3, newFrames / 4);
+        hi = T1 - newFrames;
+    }
+    lastMacs = 0;
+
+    // A conv row goes stale when any row within half a kernel did, and the
+    // rows within half a kernel of the window start change their padding
+    lo += K1 / 2;
+    hi -= K1 / 2;
+    lastMacs += conv(features, T1, W1, 1, w1, b1, K1, C1, conv1, lo, hi, full);
+
+    // A pooled row goes stale when either of its inputs did
+    lo = (lo + 1) / 2;
+    hi = hi / 2;
+    if (full || lo >= hi) {
+        poolRows(conv1, W1, C1, 2, 1, pool1, 0, T2);
+    } else {
+        poolRows(conv1, W1, C1, 2, 1, pool1, 0, lo);
+        poolRows(conv1, W1, C1, 2, 1, pool1, hi, T2);
+    }
+
+    lo += K2 / 2;
+    hi -= K2 / 2;
+    lastMacs += conv(pool1, T2, W1, C1, w2, b2, K2, C2, conv2, lo, hi, full);
+
+    lo = (lo + 1) / 2;
+    hi = hi / 2;
+    if (full || lo >= hi) {
+        poolRows(conv2, W1, C2, 2, 2, pool2, 0, T3);
+    } else {
+        poolRows(conv2, W1, C2, 2, 2, pool2, 0, lo);
+        poolRows(conv2, W1, C2, 2, 2, pool2, hi, T3);
+    }
+
+    lo += K3 / 2;
+    hi -= K3 / 2;
+    lastMacs += conv(pool2, T3, W3, C2, w3, b3, K3, C3, conv3, lo, hi, full);
+    primed = true;
+
+    // Global mean, then the dense head; cheap enough to run in full
+    float mean[C3];
+    for (int c = 0; c < C3; c++) mean[c] = 0.0f;
+    for (int i = 0; i < T3 * W3; i++) {
+        for (int c = 0; c < C3; c++) mean[c] += conv3[i * C3 + c];
+    }
+    for (int c = 0; c < C3; c++) mean[c] /= T3 * W3;
+
+    float logit = fcb2;
+    for (int j = 0; j < DENSE; j++) {
+        float acc = fcb1[j];
+        for (int c = 0; c < C3; c++) acc += fc1[j * C3 + c] * mean[c];
+        if (acc > 0.0f) logit += fc2[j] * acc;
+    }
+    return 1.0f / (1.0f + expf(-logit));
+}
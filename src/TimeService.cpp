@@ -0,0 +1,268 @@
+// ============================================================================
+// TimeService.cpp - Monotonic wall clock disciplined by non-blocking SNTP
+// ============================================================================
+#include <WiFi.h>
+#include "esp_timer.h"
+#include "TimeService.h"
+
+static uint32_t readBE32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static void writeBE32(uint8_t* p, uint32_t v) {
+    p[0] = v >> 24;
+    p[1] = v >> 16;
+    p[2] = v >> 8;
+    p[3] = v;
+}
+
+// NTP 64-bit timestamp (seconds since 1900 + 32-bit fraction) -> unix microseconds
+static int64_t ntpToUnixUs(const uint8_t* p, uint32_t unixOffset) {
+    int64_t seconds = (int64_t)readBE32(p) - unixOffset;
+    int64_t fracUs = ((uint64_t)readBE32(p + 4) * 1000000ULL) >> 32;
+    return seconds * 1000000LL + fracUs;
+}
+
+TimeService::TimeService() :
+    server(NTP_SERVER),
+    serverResolved(false),
+    udpStarted(false),
+    dnsState(DNS_IDLE),
+    dnsAddress(0),
+    dnsStart(0),
+    utcOffsetSec(UTC_OFFSET_SEC),
+    anchorMonoUs(0),
+    anchorEpochUs(0),
+    driftPpb(0),
+    pendingSlewUs(0),
+    timeSet(false),
+    syncCount(0),
+    awaitingReply(false),
+    requestMonoUs(0),
+    nextSyncAt(0),
+    pollInterval(MIN_POLL_INTERVAL),
+    syncRequested(true) {
+}
+
+void TimeService::begin(const char* server, long utcOffsetSec) {
+    this->server = server;
+    this->utcOffsetSec = utcOffsetSec;
+    serverResolved = false;
+    dnsState = DNS_IDLE;
+    syncRequested = true;
+}
+
+void TimeService::onDnsFound(const char* name, const ip_addr_t* address, void* context) {
+    TimeService* self = static_cast<TimeService*>(context);
+    if (address && IP_IS_V4(address)) {
+        self->dnsAddress = ip4_addr_get_u32(ip_2_ip4(address));
+        self->dnsState = DNS_RESOLVED;
+    } else {
+        self->dnsState = DNS_FAILED;
+    }
+}
+
+// Starts the lookup, or checks on it; true once serverIP is usable
+bool TimeService::resolveServer() {
+    if (serverResolved) return true;
+
+    if (dnsState == DNS_IDLE) {
+        ip_addr_t address;
+        dnsStart = millis();
+        dnsState = DNS_PENDING;
+        err_t err = dns_gethostbyname(server, &address, onDnsFound, this);
+        if (err == ERR_OK) {
+            // Answered from lwIP's cache, no callback follows
+            dnsAddress = ip4_addr_get_u32(ip_2_ip4(&address));
+            dnsState = DNS_RESOLVED;
+        } else if (err != ERR_INPROGRESS) {
+            dnsState = DNS_FAILED;
+        }
+    }
+
+    if (dnsState == DNS_RESOLVED) {
+        serverIP = IPAddress(dnsAddress);
+        serverResolved = true;
+        dnsState = DNS_IDLE;
+    }
+    return serverResolved;
+}
+
+int64_t TimeService::monotonicUs() {
+    return esp_timer_get_time();
+}
+
+int64_t TimeService::epochUsAt(int64_t monoUs) {
+    int64_t elapsed = monoUs - anchorMonoUs;
+    int64_t driftCorr = elapsed * driftPpb / 1000000000LL;
+
+    // Apply the outstanding correction at a bounded rate so time never jumps
+    int64_t maxSlew = elapsed * MAX_SLEW_PPM / 1000000LL;
+    int64_t slew = pendingSlewUs;
+    if (slew > maxSlew) slew = maxSlew;
+    if (slew < -maxSlew) slew = -maxSlew;
+
+    return anchorEpochUs + elapsed + driftCorr + slew;
+}
+
+int64_t TimeService::nowUs() {
+    portENTER_CRITICAL(&lock);
+    int64_t us = epochUsAt(monotonicUs());
+    portEXIT_CRITICAL(&lock);
+    return us;
+}
+
+uint32_t TimeService::now() {
+    if (!timeSet) return 0;
+    return (uint32_t)(nowUs() / 1000000LL + utcOffsetSec);
+}
+
+void TimeService::getLocalTime(int& hours, int& minutes, int& seconds, int& day) {
+    uint32_t t = now();
+    hours = (t % 86400L) / 3600;
+    minutes = (t % 3600) / 60;
+    seconds = t % 60;
+    day = ((t / 86400L) + 4) % 7;  // 1970-01-01 was a Thursday
+}
+
+bool TimeService::sendRequest() {
+    if (!udpStarted) {
+        udpStarted = udp.begin(LOCAL_PORT);
+        if (!udpStarted) return false;
+    }
+
+    uint8_t packet[NTP_PACKET_SIZE];
+    memset(packet, 0, NTP_PACKET_SIZE);
+    packet[0] = 0x1B;  // LI = 0, VN = 3, Mode = 3 (client)
+
+    // Our monotonic send time goes in the transmit field; the server echoes it
+    // back as the originate timestamp, which lets us match the reply
+    requestMonoUs = monotonicUs();
+    writeBE32(&packet[40], (uint32_t)(requestMonoUs >> 32));
+    writeBE32(&packet[44], (uint32_t)requestMonoUs);
+
+    if (!udp.beginPacket(serverIP, NTP_PORT)) return false;
+    udp.write(packet, NTP_PACKET_SIZE);
+    if (!udp.endPacket()) return false;
+
+    awaitingReply = true;
+    return true;
+}
+
+void TimeService::receiveReply() {
+    int size = udp.parsePacket();
+    if (size <= 0) return;
+
+    int64_t replyMonoUs = monotonicUs();
+    uint8_t packet[NTP_PACKET_SIZE];
+    if (size < NTP_PACKET_SIZE || udp.read(packet, NTP_PACKET_SIZE) != NTP_PACKET_SIZE) {
+        udp.flush();
+        return;
+    }
+    udp.flush();
+
+    uint8_t mode = packet[0] & 0x07;
+    uint8_t stratum = packet[1];
+    int64_t originate = ((int64_t)readBE32(&packet[24]) << 32) | readBE32(&packet[28]);
+    if (mode != 4 || stratum == 0 || originate != requestMonoUs) {
+        return;  // Not ours, or a kiss-of-death
+    }
+    awaitingReply = false;
+
+    int64_t serverRx = ntpToUnixUs(&packet[32], NTP_UNIX_OFFSET);
+    int64_t serverTx = ntpToUnixUs(&packet[40], NTP_UNIX_OFFSET);
+    int64_t roundTrip = (replyMonoUs - requestMonoUs) - (serverTx - serverRx);
+    if (roundTrip < 0) roundTrip = 0;
+
+    discipline(serverTx + roundTrip / 2, replyMonoUs);
+
+    pollInterval *= 2;
+    if (pollInterval > MAX_POLL_INTERVAL) pollInterval = MAX_POLL_INTERVAL;
+    nextSyncAt = millis() + pollInterval;
+}
+
+void TimeService::discipline(int64_t measuredEpochUs, int64_t monoUs) {
+    if (!timeSet) {
+        portENTER_CRITICAL(&lock);
+        anchorMonoUs = monoUs;
+        anchorEpochUs = measuredEpochUs;
+        pendingSlewUs = 0;
+        timeSet = true;
+        portEXIT_CRITICAL(&lock);
+        syncCount = 1;
+        Serial.println("[TIME] Clock set from SNTP");
+        return;
+    }
+
+    portENTER_CRITICAL(&lock);
+    int64_t elapsed = monoUs - anchorMonoUs;
+    int64_t predicted = epochUsAt(monoUs);
+    int64_t offset = measuredEpochUs - predicted;
+    bool stepped = offset > STEP_THRESHOLD_US || offset < -STEP_THRESHOLD_US;
+
+    if (stepped) {
+        anchorMonoUs = monoUs;
+        anchorEpochUs = measuredEpochUs;
+        pendingSlewUs = 0;
+    } else {
+        // Whatever is left of the previous correction is not oscillator error
+        int64_t maxSlew = elapsed * MAX_SLEW_PPM / 1000000LL;
+        int64_t applied = pendingSlewUs;
+        if (applied > maxSlew) applied = maxSlew;
+        if (applied < -maxSlew) applied = -maxSlew;
+        int64_t driftError = offset - (pendingSlewUs - applied);
+
+        // Short intervals are dominated by network jitter, not drift
+        if (elapsed > 16000000LL) {
+            int32_t measuredPpb = (int32_t)(driftError * 1000000000LL / elapsed);
+            driftPpb += measuredPpb / 2;
+            if (driftPpb > MAX_DRIFT_PPB) driftPpb = MAX_DRIFT_PPB;
+            if (driftPpb < -MAX_DRIFT_PPB) driftPpb = -MAX_DRIFT_PPB;
+        }
+
+        // Re-anchor on the predicted (continuous) time and slew the rest in
+        anchorMonoUs = monoUs;
+        anchorEpochUs = predicted;
+        pendingSlewUs = offset;
+    }
+    portEXIT_CRITICAL(&lock);
+    syncCount++;
+
+    if (stepped) {
+        Serial.printf("[TIME] Stepping clock by %lld ms\n", offset / 1000);
+    } else {
+        Serial.printf("[TIME] SNTP offset %lld us, drift %ld ppb\n", offset, (long)driftPpb);
+    }
+}
+
+void TimeService::loop() {
+    unsigned long nowMillis = millis();
+
+    if (awaitingReply) {
+        receiveReply();
+        if (awaitingReply && (monotonicUs() - requestMonoUs) / 1000 > REPLY_TIMEOUT) {
+            awaitingReply = false;
+            nextSyncAt = nowMillis + RETRY_INTERVAL;
+        }
+        return;
+    }
+
+    if (WiFi.status() != WL_CONNECTED) return;
+
+    if (syncRequested || (long)(nowMillis - nextSyncAt) >= 0) {
+        // The lookup runs in the background; poll it on later calls
+        if (!resolveServer()) {
+            if (dnsState == DNS_PENDING && nowMillis - dnsStart < DNS_TIMEOUT) return;
+            Serial.printf("[TIME] Could not resolve %s\n", server);
+            dnsState = DNS_IDLE;
+            syncRequested = false;
+            nextSyncAt = nowMillis + RETRY_INTERVAL;
+            return;
+        }
+
+        syncRequested = false;
+        if (!sendRequest()) {
+            nextSyncAt = nowMillis + RETRY_INTERVAL;
+        }
+    }
+}
@@ -0,0 +1,146 @@
+// ============================================================================
+// UiService.cpp - LCD rendering task fed by a message queue
+// ============================================================================
+#include "UiService.h"
+
+UiService::UiService() :
+    display(nullptr),
+    queue(nullptr),
+    task(nullptr),
+    statusLock(xSemaphoreCreateMutex()),
+    droppedMessages(0),
+    toastActive(false),
+    toastExpiresAt(0),
+    pendingCount(0) {
+    lastPostedStatus[0] = '\0';
+    statusText[0] = '\0';
+}
+
+void UiService::begin(TimeService* clockSource) {
+    display = new LcdTimeDisplay();
+    display->begin(clockSource);
+
+    queue = xQueueCreate(QUEUE_LENGTH, sizeof(Message));
+
+    // Arduino loop() runs on core 1; keep LCD bit-banging off it
+    xTaskCreatePinnedToCore(taskEntry, "ui", TASK_STACK_SIZE, this, 1, &task, 0);
+}
+
+bool UiService::post(MessageType type, const char* text, uint16_t durationMs, uint8_t priority) {
+    Message msg;
+    msg.type = type;
+    msg.priority = priority;
+    msg.durationMs = durationMs;
+    strncpy(msg.text, text, LCD_COLS);
+    msg.text[LCD_COLS] = '\0';
+
+    if (!queue || xQueueSend(queue, &msg, 0) != pdTRUE) {
+        droppedMessages++;
+        return false;
+    }
+    return true;
+}
+
+void UiService::status(const char* text) {
+    // Held only for a compare and a non-blocking send
+    xSemaphoreTake(statusLock, portMAX_DELAY);
+    if (strncmp(lastPostedStatus, text, LCD_COLS) != 0 && post(MSG_STATUS, text, 0, PRIORITY_LOW)) {
+        strncpy(lastPostedStatus, text, LCD_COLS);
+        lastPostedStatus[LCD_COLS] = '\0';
+    }
+    xSemaphoreGive(statusLock);
+}
+
+void UiService::toast(const char* text, uint16_t durationMs, uint8_t priority) {
+    post(MSG_TOAST, text, durationMs, priority);
+}
+
+void UiService::taskEntry(void* param) {
+    static_cast<UiService*>(param)->run();
+}
+
+void UiService::showToast(const Message& msg) {
+    activeToast = msg;
+    toastActive = true;
+    toastExpiresAt = millis() + msg.durationMs;
+}
+
+void UiService::handleMessage(const Message& msg) {
+    if (msg.type == MSG_STATUS) {
+        memcpy(statusText, msg.text, sizeof(statusText));
+        return;
+    }
+
+    // Higher priority preempts; equal or lower waits its turn in order
+    if (!toastActive || msg.priority > activeToast.priority) {
+        if (toastActive) requeueActiveToast();
+        showToast(msg);
+    } else if (pendingCount < MAX_PENDING_TOASTS) {
+        pendingToasts[pendingCount++] = msg;
+    } else {
+        droppedMessages++;
+    }
+}
+
+// The preempted toast goes back for what it had left, ahead of its equals
+// since it was shown first
+void UiService::requeueActiveToast() {
+    if (pendingCount >= MAX_PENDING_TOASTS) {
+        droppedMessages++;
+        return;
+    }
+
+    long remaining = (long)(toastExpiresAt - millis());
+    if (remaining <= 0) return;     // Was about to expire anyway
+    activeToast.durationMs = (uint16_t)remaining;
+
+    for (int i = pendingCount; i > 0; i--) {
+        pendingToasts[i] = pendingToasts[i - 1];
+    }
+    pendingToasts[0] = activeToast;
+    pendingCount++;
+}
+
+void UiService::expireToast() {
+    toastActive = false;
+    if (pendingCount == 0) return;
+
+    // Highest priority first, FIFO among equals
+    int next = 0;
+    for (int i = 1; i < pendingCount; i++) {
+        if (pendingToasts[i].priority > pendingToasts[next].priority) next = i;
+    }
+    showToast(pendingToasts[next]);
+
+    for (int i = next; i < pendingCount - 1; i++) {
+        pendingToasts[i] = pendingToasts[i + 1];
+    }
+    pendingCount--;
+}
+
+void UiService::run() {
+    Message msg;
+
+    for (;;) {
+        unsigned long waitMs = MAX_IDLE_WAIT_MS;
+        if (toastActive) {
+            long remaining = (long)(toastExpiresAt - millis());
+            if (remaining < 0) remaining = 0;
+            if ((unsigned long)remaining < waitMs) waitMs = remaining;
+        }
+
+        if (xQueueReceive(queue, &msg, pdMS_TO_TICKS(waitMs)) == pdTRUE) {
+            handleMessage(msg);
+            while (xQueueReceive(queue, &msg, 0) == pdTRUE) {
+                handleMessage(msg);
+            }
+        }
+
+        while (toastActive && (long)(millis() - toastExpiresAt) >= 0) {
+            expireToast();
+        }
+
+        display->updateStatus(toastActive ? activeToast.text : statusText);
+        display->updateTime();
+    }
+}
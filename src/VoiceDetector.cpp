@@ -2,6 +2,7 @@
 // VoiceDetector.cpp - Process int16_t directly
 // ============================================================================
 #include "VoiceDetector.h"
+#include "StreamingCnn.h"
 
 VoiceDetector::VoiceDetector() {
     nn = new NeuralNetwork();
@@ -13,20 +14,37 @@ VoiceDetector::~VoiceDetector() {
     delete audioProcessor;
 }
 
-float VoiceDetector::detectWakeWord(const int16_t* audio, int length) {
-    // Extract MFCC features directly from int16_t audio
-    audioProcessor->extractMFCC(audio, length, mfcc_features);
+float VoiceDetector::detectWakeWord(const SampleView& audio, int advance) {
+    int newFrames = extractFeatures(audio, advance);
+    return scoreFeatures(getFeatures(), newFrames);
+}
+
+int VoiceDetector::extractFeatures(const SampleView& audio, int advance,
+                                   const SampleView* mic1, const SampleView* mic2) {
+    int newFrames = N_FRAMES;
+    if (featuresValid && advance >= 0 && advance % HOP_LENGTH == 0 && advance / HOP_LENGTH < N_FRAMES) {
+        newFrames = advance / HOP_LENGTH;
+    }
+    
+    // Frames still inside the window slide to the front; only new ones are
+    // extracted
+    int kept = N_FRAMES - newFrames;
+    if (kept > 0) memmove(mfcc_features[0], mfcc_features[newFrames], kept * sizeof(mfcc_features[0]));
+    audioProcessor->extractMFCCFrom(audio, mfcc_features, kept, mic1, mic2,
+                                    mic1 && mic2 ? &spectra : nullptr);
+    featuresValid = true;
+    return newFrames;
+}
+
+float VoiceDetector::scoreFeatures(const float* features, int newFrames) {
+    StreamingCnn* streaming = nn->getStreaming();
+    if (streaming) return streaming->predict(features, newFrames);
     
     // Get input buffer from neural network
     float* input_buffer = nn->getInputBuffer();
     
     // Copy MFCC features to input buffer
-    int idx = 0;
-    for (int frame = 0; frame < N_FRAMES; frame++) {
-        for (int mfcc = 0; mfcc < N_MFCC; mfcc++) {
-            input_buffer[idx++] = mfcc_features[frame][mfcc];
-        }
-    }
+    memcpy(input_buffer, features, N_FRAMES * N_MFCC * sizeof(float));
     
     // Run inference
     float score = nn->predict();
@@ -0,0 +1,66 @@
+// ============================================================================
+// WakeDecision.cpp - Wake-word trigger logic over a stream of window scores
+// ============================================================================
+#include "WakeDecision.h"
+
+// Defence on stays at the original operating point, one raw window above
+// 0.999, until k-of-n is calibrated against recorded positives: the model
+// rarely scores 0.999 twice in three windows of one utterance. Defence off
+// averages pairs of windows instead
+const WakeDecision::Mode WakeDecision::STRICT = {"strict", 0.999f, 1, 1, 1, 2000};
+const WakeDecision::Mode WakeDecision::RELAXED = {"relaxed", 0.90f, 2, 1, 1, 2000};
+
+WakeDecision::WakeDecision(const Mode& mode) : mode(&mode) {
+    reset();
+}
+
+void WakeDecision::setMode(const Mode& mode) {
+    if (this->mode == &mode) return;
+    this->mode = &mode;
+    reset();
+}
+
+void WakeDecision::reset() {
+    head = 0;
+    count = 0;
+    average = 0.0f;
+    peak = 0.0f;
+    hits = 0;
+    refractory = false;
+}
+
+bool WakeDecision::update(float score, uint32_t nowMs) {
+    if (refractory && nowMs - refractoryStart >= mode->refractoryMs) refractory = false;
+
+    scores[head] = score;
+    if (count < MAX_WINDOWS) count++;
+
+    // Moving average over the newest scores available
+    int n = mode->smoothing < count ? mode->smoothing : count;
+    float sum = 0.0f;
+    for (int i = 0; i < n; i++) {
+        sum += scores[(head - i + MAX_WINDOWS) % MAX_WINDOWS];
+    }
+    average = sum / n;
+    averages[head] = average;
+    head = (head + 1) % MAX_WINDOWS;
+
+    // k of the last n averages, and the peak among them
+    int window = mode->windows < count ? mode->windows : count;
+    hits = 0;
+    peak = 0.0f;
+    for (int i = 1; i <= window; i++) {
+        float a = averages[(head - i + MAX_WINDOWS) % MAX_WINDOWS];
+        if (a > mode->threshold) hits++;
+        if (a > peak) peak = a;
+    }
+
+    if (refractory || hits < mode->required) return false;
+
+    // Windows that fired must not fire again once the period is over
+    refractory = true;
+    refractoryStart = nowMs;
+    head = 0;
+    count = 0;
+    return true;
+}
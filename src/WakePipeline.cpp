@@ -0,0 +1,96 @@
+// ============================================================================
+// WakePipeline.cpp - Wake-word capture/features on core 0, scoring on core 1
+// ============================================================================
+#include "WakePipeline.h"
+
+void WakePipeline::begin(Source source, void* context) {
+    this->source = source;
+    sourceContext = context;
+    resetStats();
+
+    queue = xQueueCreate(QUEUE_LENGTH, sizeof(Window));
+
+    // Same priority as the UI task on core 0, so both keep running
+    xTaskCreatePinnedToCore(taskEntry, "wake", TASK_STACK_SIZE, this, 1, &task, 0);
+}
+
+void WakePipeline::start() {
+    if (!task || active) return;
+
+    // Anything still queued belongs to the window before the stop
+    xQueueReset(queue);
+    resync = true;
+
+    idle = false;
+    active = true;
+    xTaskNotifyGive(task);
+}
+
+void WakePipeline::stop() {
+    if (!task) return;
+    active = false;
+    while (!idle) vTaskDelay(1);
+}
+
+void WakePipeline::taskEntry(void* param) {
+    static_cast<WakePipeline*>(param)->run();
+}
+
+void WakePipeline::run() {
+    for (;;) {
+        if (!active) {
+            idle = true;
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+            // Busy again before active is rechecked, so a stop() from here
+            // on waits for this pass
+            idle = false;
+            continue;
+        }
+        produce();
+    }
+}
+
+// One capture chunk; on a finished window, its features go to the queue.
+// The ADC's DMA keeps sampling through the features, so the next chunk
+// picks up where this one ended.
+void WakePipeline::produce() {
+    if (!source(staging, sourceContext)) return;
+
+    if (resync) staging.newFrames = N_FRAMES;
+    staging.sequence = sequence++;
+    staging.readyAt = millis();
+
+    if (staging.featureMicros > stats.maxFeatureMicros) stats.maxFeatureMicros = staging.featureMicros;
+    stats.produced++;
+
+    // Never block the capture; a dropped window breaks the column cache
+    if (xQueueSend(queue, &staging, 0) == pdTRUE) {
+        resync = false;
+        uint8_t depth = uxQueueMessagesWaiting(queue);
+        if (depth > stats.maxDepth) stats.maxDepth = depth;
+    } else {
+        stats.dropped++;
+        resync = true;
+    }
+}
+
+const WakePipeline::Window* WakePipeline::poll() {
+    if (!queue || xQueueReceive(queue, &current, 0) != pdTRUE) return nullptr;
+
+    uint32_t latency = millis() - current.readyAt;
+    if (latency > stats.maxLatencyMs) stats.maxLatencyMs = latency;
+    stats.consumed++;
+    return &current;
+}
+
+void WakePipeline::resetStats() {
+    memset(&stats, 0, sizeof(stats));
+}
+
+void WakePipeline::printStats(const char* label) {
+    Serial.printf("[PIPE] %s: %lu windows, %lu dropped, %lu scored, queue max %u/%d, latency max %lu ms, features max %lu us\n",
+                  label, (unsigned long)stats.produced, (unsigned long)stats.dropped,
+                  (unsigned long)stats.consumed, stats.maxDepth, QUEUE_LENGTH,
+                  (unsigned long)stats.maxLatencyMs, (unsigned long)stats.maxFeatureMicros);
+}
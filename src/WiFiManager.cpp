@@ -0,0 +1,239 @@
+// ============================================================================
+// WiFiManager.cpp - Event-driven WiFi connection with cached AP fast-connect
+// ============================================================================
+#include "WiFiManager.h"
+
+WiFiManager* WiFiManager::instance = nullptr;
+
+WiFiManager::WiFiManager() :
+    ssid(nullptr),
+    password(nullptr),
+    cacheValid(false),
+    state(WIFI_IDLE),
+    stateStart(0),
+    connectStart(0),
+    lastConnectDuration(0),
+    gotIpEvent(false),
+    disconnectEvent(false),
+    disconnectReason(0),
+    connectedEdge(false),
+    disconnectedEdge(false) {
+    memset(&cache, 0, sizeof(cache));
+}
+
+void WiFiManager::begin(const char* ssid, const char* password) {
+    this->ssid = ssid;
+    this->password = password;
+    instance = this;
+
+    // We drive reconnects ourselves; the driver's own retry would race us
+    WiFi.persistent(false);
+    WiFi.setAutoReconnect(false);
+    WiFi.mode(WIFI_STA);
+    WiFi.onEvent(onWiFiEvent);
+
+    cacheValid = loadCache();
+    connectStart = millis();
+    if (cacheValid) {
+        startFastConnect();
+    } else {
+        startScan();
+    }
+}
+
+void WiFiManager::onWiFiEvent(WiFiEvent_t event, WiFiEventInfo_t info) {
+    if (!instance) return;
+
+    switch (event) {
+        case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+            instance->gotIpEvent = true;
+            break;
+        case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+            instance->disconnectReason = info.wifi_sta_disconnected.reason;
+            instance->disconnectEvent = true;
+            break;
+        default:
+            break;
+    }
+}
+
+bool WiFiManager::loadCache() {
+    prefs.begin("wifi", true);
+    size_t len = prefs.getBytes("ap", &cache, sizeof(cache));
+    prefs.end();
+
+    if (len != sizeof(cache) || cache.magic != CACHE_MAGIC || cache.channel == 0) {
+        memset(&cache, 0, sizeof(cache));
+        return false;
+    }
+
+    Serial.printf("[WiFi] Cached AP %02X:%02X:%02X:%02X:%02X:%02X ch %d\n",
+                  cache.bssid[0], cache.bssid[1], cache.bssid[2],
+                  cache.bssid[3], cache.bssid[4], cache.bssid[5], cache.channel);
+    return true;
+}
+
+void WiFiManager::saveCache() {
+    CachedAp fresh;
+    memset(&fresh, 0, sizeof(fresh));
+    fresh.magic = CACHE_MAGIC;
+    memcpy(fresh.bssid, WiFi.BSSID(), sizeof(fresh.bssid));
+    fresh.channel = WiFi.channel();
+
+    // Only touch flash when the association actually changed
+    if (cacheValid && memcmp(&fresh, &cache, sizeof(cache)) == 0) {
+        return;
+    }
+
+    cache = fresh;
+    cacheValid = true;
+    prefs.begin("wifi", false);
+    prefs.putBytes("ap", &cache, sizeof(cache));
+    prefs.end();
+    Serial.println("[WiFi] AP cache updated");
+}
+
+void WiFiManager::clearCache() {
+    cacheValid = false;
+    memset(&cache, 0, sizeof(cache));
+    prefs.begin("wifi", false);
+    prefs.remove("ap");
+    prefs.end();
+}
+
+void WiFiManager::enterState(State newState) {
+    state = newState;
+    stateStart = millis();
+}
+
+void WiFiManager::startFastConnect() {
+    Serial.println("[WiFi] Fast-connect using cached AP...");
+    gotIpEvent = false;
+    disconnectEvent = false;
+
+    // Skipping the scan is the saving; the address still comes from DHCP
+    // so an expired lease can never be reused as a static IP
+    WiFi.config(IPAddress((uint32_t)0), IPAddress((uint32_t)0), IPAddress((uint32_t)0));
+    WiFi.begin(ssid, password, cache.channel, cache.bssid, true);
+    enterState(WIFI_FAST_CONNECTING);
+}
+
+void WiFiManager::startScan() {
+    Serial.println("[WiFi] Scanning for AP...");
+    WiFi.disconnect(false);
+    WiFi.scanDelete();
+    WiFi.scanNetworks(true);  // async, result polled in loop()
+    enterState(WIFI_SCANNING);
+}
+
+void WiFiManager::startConnect(const uint8_t* bssid, int32_t channel) {
+    gotIpEvent = false;
+    disconnectEvent = false;
+
+    WiFi.config(IPAddress((uint32_t)0), IPAddress((uint32_t)0), IPAddress((uint32_t)0));
+    WiFi.begin(ssid, password, channel, bssid, true);
+    enterState(WIFI_CONNECTING);
+}
+
+void WiFiManager::handleScanResult() {
+    int n = WiFi.scanComplete();
+    if (n == WIFI_SCAN_RUNNING) return;
+
+    int best = -1;
+    for (int i = 0; i < n; i++) {
+        if (WiFi.SSID(i) != ssid) continue;
+        if (best < 0 || WiFi.RSSI(i) > WiFi.RSSI(best)) best = i;
+    }
+
+    if (best >= 0) {
+        uint8_t bssid[6];
+        memcpy(bssid, WiFi.BSSID(best), sizeof(bssid));
+        int32_t channel = WiFi.channel(best);
+        Serial.printf("[WiFi] Found %s on ch %d (RSSI %d, %d networks)\n",
+                      ssid, channel, WiFi.RSSI(best), n);
+        WiFi.scanDelete();
+        startConnect(bssid, channel);
+    } else {
+        // Hidden SSID or scan failure: let the driver search on its own
+        Serial.printf("[WiFi] %s not in scan (%d networks)\n", ssid, n < 0 ? 0 : n);
+        WiFi.scanDelete();
+        startConnect(nullptr, 0);
+    }
+}
+
+void WiFiManager::handleConnected() {
+    lastConnectDuration = millis() - connectStart;
+    enterState(WIFI_CONNECTED);
+    connectedEdge = true;
+    saveCache();
+
+    Serial.printf("[WiFi] Connected in %lu ms, IP: %s\n",
+                  lastConnectDuration, WiFi.localIP().toString().c_str());
+}
+
+void WiFiManager::loop() {
+    unsigned long elapsed = millis() - stateStart;
+
+    switch (state) {
+        case WIFI_IDLE:
+            break;
+
+        case WIFI_FAST_CONNECTING:
+            if (gotIpEvent) {
+                handleConnected();
+            } else if (disconnectEvent || elapsed > FAST_CONNECT_TIMEOUT) {
+                Serial.printf("[WiFi] Fast-connect failed (reason %d), falling back to scan\n",
+                              disconnectEvent ? disconnectReason : 0);
+                startScan();
+            }
+            break;
+
+        case WIFI_SCANNING:
+            handleScanResult();
+            break;
+
+        case WIFI_CONNECTING:
+            if (gotIpEvent) {
+                handleConnected();
+            } else if (disconnectEvent || elapsed > CONNECT_TIMEOUT) {
+                Serial.printf("[WiFi] Connection FAILED (reason %d)\n",
+                              disconnectEvent ? disconnectReason : 0);
+                if (cacheValid) clearCache();
+                WiFi.disconnect(false);
+                enterState(WIFI_BACKOFF);
+            }
+            break;
+
+        case WIFI_CONNECTED:
+            if (disconnectEvent) {
+                Serial.printf("[WiFi] Disconnected (reason %d), reconnecting...\n", disconnectReason);
+                disconnectedEdge = true;
+                connectStart = millis();
+                if (cacheValid) {
+                    startFastConnect();
+                } else {
+                    startScan();
+                }
+            }
+            break;
+
+        case WIFI_BACKOFF:
+            if (elapsed > RETRY_BACKOFF) {
+                connectStart = millis();
+                startScan();
+            }
+            break;
+    }
+}
+
+bool WiFiManager::justConnected() {
+    bool edge = connectedEdge;
+    connectedEdge = false;
+    return edge;
+}
+
+bool WiFiManager::justDisconnected() {
+    bool edge = disconnectedEdge;
+    disconnectedEdge = false;
+    return edge;
+}
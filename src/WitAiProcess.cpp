@@ -3,6 +3,7 @@
 #include <WiFiClientSecure.h>
 #include <ArduinoJson.h>
 #include "AudioRecorder.h"
+#include "NoiseSuppressor.h"
 #include "config.h"
 #include "WitAiProcess.h"
 #include "utils.h"
@@ -13,6 +14,9 @@ volatile bool bufferReady_wit = false;
 volatile bool shouldRecord_wit = false;
 volatile bool dataReadyToConsume_wit = false;  
 
+// Upload-side denoiser; its noise floor carries over between commands
+NoiseSuppressor uploadDenoiser;
+
 WiFiClientSecure* wifiClient = nullptr;
 
 void testConnection_wit();
@@ -22,6 +26,15 @@ void parseWitAiResponse();
 
 ProcessStates p_states;
 
+// Denoiser output trails its input by LATENCY and opens with that much
+// lead-in, so output sample k of the stream belongs at k - LATENCY
+static void storeDenoised(const int16_t* samples, int count, int streamIndex) {
+  for (int i = 0; i < count; i++) {
+    int k = streamIndex + i - NoiseSuppressor::LATENCY;
+    if (k >= 0) ringBuffer1[k] = samples[i];
+  }
+}
+
 bool WIT_loop() {
     // Check for buffer allocation
   if (!buffersAllocated || !ringBuffer1) {
@@ -47,28 +60,40 @@ bool WIT_loop() {
   
   // Recording loop
   if (shouldRecord_wit) {
-    unsigned long startTime = micros();
+    int16_t frames[2 * CAPTURE_CHUNK];
+    int16_t beam[CAPTURE_CHUNK];
+    int count = BUFFER_SIZE_MIC1 - writeIndex_wit;
+    if (count > CAPTURE_CHUNK) count = CAPTURE_CHUNK;
+    MIC_readFrames(frames, count);
     
-    for (int i = 0; i < 100; i++) {
-      if (writeIndex_wit >= BUFFER_SIZE_MIC1) {
-        bufferReady_wit = true;
-        shouldRecord_wit = false;
-        writeIndex_wit = 0;
-        break;
-      }
-      
-      // Read microphone with DC offset removal and amplification
-      ringBuffer1[writeIndex_wit] = (int16_t)((analogRead(micPin1) - 2048) * 16);
-      writeIndex_wit++;
-      
-      // Timing for 16kHz sampling
-      while (micros() - startTime < (i + 1) * 62.5) {}
+    // Steered toward the talker found during the wake word
+    unsigned long workStart = micros();
+    beamformer.process(frames, count, beam);
+    uploadDenoiser.process(beam, count);
+    storeDenoised(beam, count, writeIndex_wit);
+    MIC_chargeWork(micros() - workStart);
+    writeIndex_wit += count;
+    
+    if (writeIndex_wit >= BUFFER_SIZE_MIC1) {
+      // The last LATENCY samples are still inside the denoiser
+      int16_t tail[NoiseSuppressor::LATENCY];
+      uploadDenoiser.flush(tail);
+      storeDenoised(tail, NoiseSuppressor::LATENCY, BUFFER_SIZE_MIC1);
+      bufferReady_wit = true;
+      shouldRecord_wit = false;
+      writeIndex_wit = 0;
     }
     
     // When buffer is full, send to both Wit.ai AND Python
     if (bufferReady_wit) {
       Serial.println("RECORDING COMPLETE");
-      lcdDisplay->updateStatus(LcdTimeDisplay::STATUS_PROCESSING_WIT);
+      MIC_printLevels("wit");
+      MIC_printLoad("wit");
+      Serial.printf("[DENOISE] %lu frames, last %lu us, max %lu us\n",
+                    (unsigned long)uploadDenoiser.getFrameCount(),
+                    (unsigned long)uploadDenoiser.getLastFrameMicros(),
+                    (unsigned long)uploadDenoiser.getMaxFrameMicros());
+      ui->status(LcdTimeDisplay::STATUS_PROCESSING_WIT);
       
       // First send to Python for saving
       // sendBufferToPython_wit();
@@ -93,6 +118,10 @@ void startRecording_wit() {
   writeIndex_wit = 0;
   bufferReady_wit = false;
   shouldRecord_wit = true;
+  beamformer.reset();
+  uploadDenoiser.restart();
+  micGain.resetStats();
+  MIC_drain();
   Serial.println("RECORDING STARTED - Filling 3 second buffer...");
 }
 
@@ -0,0 +1,97 @@
+// ============================================================================
+// WorkerPool.cpp - Splits a loop across the caller and helper tasks
+// ============================================================================
+#include "WorkerPool.h"
+
+WorkerPool::WorkerPool() : next(0) {
+    for (int i = 0; i < MAX_HELPERS; i++) {
+        helpers[i].pool = this;
+        helpers[i].task = nullptr;
+        helpers[i].state.store(HELPER_IDLE);
+    }
+    resetStats();
+}
+
+WorkerPool::~WorkerPool() {
+    // run() has returned, so every helper is parked in ulTaskNotifyTake
+    for (int i = 0; i < helperCount; i++) vTaskDelete(helpers[i].task);
+}
+
+bool WorkerPool::begin(int helpers, int core, int priority) {
+    if (helpers > MAX_HELPERS) helpers = MAX_HELPERS;
+
+    while (helperCount < helpers) {
+        Helper& helper = this->helpers[helperCount];
+        if (xTaskCreatePinnedToCore(helperEntry, "pool", TASK_STACK_SIZE, &helper,
+                                    priority, &helper.task, core) != pdPASS) {
+            Serial.printf("[POOL] Could not start helper %d\n", helperCount);
+            break;
+        }
+        helperCount++;
+    }
+    return helperCount > 0;
+}
+
+void WorkerPool::helperEntry(void* param) {
+    Helper& helper = *static_cast<Helper*>(param);
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        // A late wake-up finds its job finished (or cancelled) and sleeps on
+        int expected = HELPER_PENDING;
+        if (!helper.state.compare_exchange_strong(expected, HELPER_RUNNING)) continue;
+
+        helper.pool->work();
+
+        // The caller only sleeps on a helper it found running
+        if (helper.state.exchange(HELPER_IDLE) == HELPER_JOINING) {
+            xTaskNotifyGive(helper.pool->caller);
+        }
+    }
+}
+
+// Claims items until none are left; returns how many this task did
+int WorkerPool::work() {
+    int done = 0;
+    for (int item = next.fetch_add(1); item < count; item = next.fetch_add(1)) {
+        job(context, item);
+        done++;
+    }
+    return done;
+}
+
+void WorkerPool::run(Job job, void* context, int count) {
+    this->job = job;
+    this->context = context;
+    this->count = count;
+    next.store(0);
+    caller = xTaskGetCurrentTaskHandle();
+
+    stats.runs++;
+    stats.items += count;
+
+    // Not worth waking anyone for a single item
+    int helping = count > 1 ? helperCount : 0;
+    for (int i = 0; i < helping; i++) {
+        helpers[i].state.store(HELPER_PENDING);
+        xTaskNotifyGive(helpers[i].task);
+    }
+
+    int done = work();
+    stats.helperItems += count - done;
+
+    // Barrier: a helper still pending never claimed anything and is called
+    // off; one that is running finishes its last item and wakes us. A
+    // notification left over from elsewhere only costs one more check.
+    for (int i = 0; i < helping; i++) {
+        int expected = HELPER_PENDING;
+        if (helpers[i].state.compare_exchange_strong(expected, HELPER_IDLE)) continue;
+        expected = HELPER_RUNNING;
+        if (!helpers[i].state.compare_exchange_strong(expected, HELPER_JOINING)) continue;
+        while (helpers[i].state.load() != HELPER_IDLE) ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
+
+void WorkerPool::resetStats() {
+    memset(&stats, 0, sizeof(stats));
+}
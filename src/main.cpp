@@ -11,663 +11,777 @@
 #include "utils.h"
 #include "LaserAttackDetector.h"
 #include "LcdTimeDisplay.h"
-#include "DTMFDetector.h"  
+#include "DTMFDetector.h"
 #include "main.h"
 #include "WhatsAppVerification.h"
 #include "motor.h"
+#include "WiFiManager.h"
+#include "TimeService.h"
+#include "UiService.h"
+#include "Scheduler.h"
+#include "StateMachine.h"
+#include "WakeDecision.h"
+#include "WakePipeline.h"
 
 VoiceDetector* detector;
 LaserAttackDetector* laserDetector;
-LcdTimeDisplay* lcdDisplay;
+UiService* ui;
 DTMFDetector* dtmfDetector;
 WhatsAppVerification* whatsappVerifier;
+WiFiManager* wifiManager;
+TimeService* timeService;
+
+Scheduler scheduler;
+StateMachine machine;
+WakePipeline wakePipeline;
 
 bool defenceSet;
-float confidence;
-
-enum MainStates{
-    WIFI_CONNECT,
-    START_WAKE_WORD_STATE,
-    WAKE_WORD_STATE,
-    WIT_STATE,
-    PROCESS_INTENT,
-    DTMF_INPUT_STATE,
-    VERIFY_CODE_INPUT_STATE, 
-};
 
-MainStates m_states;
 String reminderTime = "";
 
+const uint32_t BUFFER_RETRY_MS = 2000;
+
+// Keypad shortcuts heard while listening for the wake word: '*', code, '#'.
+// Turning the defence off stays voice-only.
+struct KeyShortcut {
+    const char* code;
+    ProcessStates action;
+};
+
+const KeyShortcut KEY_SHORTCUTS[] = {
+    {"*1#", SET_REMINDER},
+    {"*2#", VERIFY_ME},
+    {"*3#", MORNING_PILL},
+    {"*4#", EVENING_PILL},
+};
+const int KEY_SHORTCUT_COUNT = sizeof(KEY_SHORTCUTS) / sizeof(KEY_SHORTCUTS[0]);
+const uint32_t KEY_SEQUENCE_TIMEOUT_MS = 3000;
+
 void Run_WifiConnectionCheck();
-void Run_WakeWord();
-bool Run_VerifyLaser();
-void Run_Wit();
-void Run_Process();
-void Run_Cleanup();
-void Run_DTMFInput();
-void Run_VerificationCodeInput();
 
-void wifiScanner();
-void connectWiFi();
-void handleIntentProcessing();
+// Wake pipeline source, on the capture core: one chunk, and on a full
+// window the beam's MFCCs plus the mic pair's spectra for the laser checks
+static bool captureWakeWindow(WakePipeline::Window& window, void* context) {
+    VoiceDetector* voice = static_cast<VoiceDetector*>(context);
+
+    // Recording stopped from the serial console; nothing to pace
+    if (!continuousRecording && !shouldRecord) {
+        vTaskDelay(1);
+        return false;
+    }
+    if (!MIC_loop()) return false;
+
+    unsigned long start = micros();
+    SampleView mic1 = MIC_pitchView(1);
+    SampleView mic2 = MIC_pitchView(2);
+    window.newFrames = voice->extractFeatures(MIC_beamView(), MIC_beamAdvance(), &mic1, &mic2);
+    acknowledgeData();
+
+    memcpy(window.features, voice->getFeatures(), sizeof(window.features));
+    window.spectraStart = voice->getSpectraStart();
+    window.featureMicros = micros() - start;
+    MIC_chargeWork(window.featureMicros);
+    return true;
+}
+
+
+// ============================================================================
+// States
+// ============================================================================
+
+class WifiConnectState : public State {
+public:
+    const char* name() { return "WIFI_CONNECT"; }
+    void tick();
+};
+
+class WakeWordState : public State {
+private:
+    Scheduler::TimerId retryTimer = Scheduler::INVALID_TIMER;
+    Scheduler::TimerId keyTimer = Scheduler::INVALID_TIMER;
+    bool laserCalibrated = false;
+    String keySequence;
+    WakeDecision decision;
+
+    void tryStart();
+    void runWakeWord();
+    bool verifyLaser();
+    bool onKey(char key);
+    void onCommand(char command);
+    static void onKeyTimeout(void* context);
+
+public:
+    const char* name() { return "WAKE_WORD"; }
+    void enter();
+    void tick();
+    void exit();
+};
+
+class WitState : public State {
+private:
+    Scheduler::TimerId retryTimer = Scheduler::INVALID_TIMER;
+
+public:
+    const char* name() { return "WIT"; }
+    void enter();
+    void tick();
+    void exit();
+};
+
+class ProcessIntentState : public State {
+private:
+    bool waitingForMotor = false;
+    const char* motorDoneMessage = nullptr;
+
+public:
+    const char* name() { return "PROCESS_INTENT"; }
+    void enter();
+    void tick();
+};
+
+class DtmfInputState : public State {
+private:
+    Scheduler::TimerId refreshTimer = Scheduler::INVALID_TIMER;
+
+    static void onRefresh(void* context);
+
+public:
+    const char* name() { return "DTMF_INPUT"; }
+    void enter();
+    void tick();
+    void exit();
+};
+
+class VerifyCodeState : public State {
+private:
+    static const int MAX_ATTEMPTS = 3;
+
+    Scheduler::TimerId blinkTimer = Scheduler::INVALID_TIMER;
+    bool showCursor = true;
+    int attemptCount = 0;
+
+    void showCode(bool withCursor);
+    static void onBlink(void* context);
+
+public:
+    const char* name() { return "VERIFY_CODE_INPUT"; }
+    void enter();
+    void tick();
+    void exit();
+};
+
+WifiConnectState wifiConnectState;
+WakeWordState wakeWordState;
+WitState witState;
+ProcessIntentState processIntentState;
+DtmfInputState dtmfInputState;
+VerifyCodeState verifyCodeState;
+
 
+// ============================================================================
+// Setup / loop
+// ============================================================================
 
 void setup() {
     Serial.begin(115200);
     while(!Serial);
-    
+
     checkMemory("Setup start");
-    
-    // Initialize LCD Display first
-    lcdDisplay = new LcdTimeDisplay();
-    lcdDisplay->begin();
-    lcdDisplay->updateStatus("Starting up...");
-    
+
+    // Wall clock for the LCD
+    timeService = new TimeService();
+    timeService->begin(NTP_SERVER, UTC_OFFSET_SEC);
+
+    // Initialize LCD Display first, rendered from its own task
+    ui = new UiService();
+    ui->begin(timeService);
+    ui->status("Starting up...");
+
     // Initialize detector
-    detector = new VoiceDetector();    
+    detector = new VoiceDetector();
     Serial.println("Model loaded!");
-    lcdDisplay->updateStatus("Model OK");
-    delay(500);
-    
+    ui->toast("Model OK", 500);
+
     laserDetector = new LaserAttackDetector();
+    laserDetector->attachSpectra(detector->getSpectra());
     Serial.println("Laser attack detector initialized");
     defenceSet = true;
-    lcdDisplay->updateStatus("Security OK");
-    delay(500);
-    
+    ui->toast("Security OK", 500);
+
     // Initialize DTMF detector
     dtmfDetector = new DTMFDetector();
     dtmfDetector->init();
     Serial.println("DTMF detector initialized");
-    lcdDisplay->updateStatus("DTMF OK");
-    delay(500);
+    ui->toast("DTMF OK", 500);
 
     MIC_setup();
+    wakePipeline.begin(captureWakeWindow, detector);
     checkMemory("After MIC setup");
-    lcdDisplay->updateStatus("Mic OK");
-    delay(500);
+    ui->toast("Mic OK", 500);
 
     whatsappVerifier = new WhatsAppVerification();
     whatsappVerifier->init(
-        WHATSAPP_PHONE_NUMBER,  
-        WHATSAPP_API_KEY        
+        WHATSAPP_PHONE_NUMBER,
+        WHATSAPP_API_KEY
     );
-    
+
     Serial.println("WhatsApp verification initialized");
-    lcdDisplay->updateStatus("WhatsApp OK");
-    delay(500);
+    ui->toast("WhatsApp OK", 500);
 
     MOTOR_setup();
     Serial.println("Motor initialized");
-    lcdDisplay->updateStatus("Motor OK");
-    delay(500);
-    
-    m_states = WIFI_CONNECT;
-    delay(1000);
+    ui->toast("Motor OK", 500);
+
+    // Connection proceeds in the background, driven by Run_WifiConnectionCheck()
+    wifiManager = new WiFiManager();
+    wifiManager->begin(WIFI_SSID, WIFI_PASSWORD);
+    ui->status(LcdTimeDisplay::STATUS_WIFI_CONNECTING);
+
+    // Background services
+    scheduler.every(10, [](void*) { timeService->loop(); });
+    scheduler.every(20, [](void*) { Run_WifiConnectionCheck(); });
+    scheduler.every(1, [](void*) { MOTOR_tick(); });
+
+    machine.transitionTo(&wifiConnectState);
 }
 
 void loop() {
-    if (m_states != DTMF_INPUT_STATE) {
-        lcdDisplay->updateTime();
+    scheduler.tick();
+    machine.tick();
+}
+
+
+// ============================================================================
+// WIFI_CONNECT
+// ============================================================================
+
+void WifiConnectState::tick() {
+    // Wait for the first attempt to settle; reconnects continue in the background
+    if (wifiManager->isAttemptFinished()) {
+        if (!wifiManager->isConnected()) {
+            Serial.println("\nWiFi connection FAILED!");
+            ui->status("WiFi Failed!");
+        }
+        machine.transitionTo(&wakeWordState);
     }
-    
-    switch (m_states)
-    {
-        case WIFI_CONNECT:
-            connectWiFi();
-            m_states = START_WAKE_WORD_STATE;
-            break;
-            
-        case START_WAKE_WORD_STATE:
-            lcdDisplay->updateStatus(LcdTimeDisplay::STATUS_INITIALIZING);
-            continuousRecording = true;
-            if (allocateWakeWordBuffers()) {
+}
+
+
+// ============================================================================
+// WAKE_WORD
+// ============================================================================
+
+void WakeWordState::enter() {
+    ui->status(LcdTimeDisplay::STATUS_INITIALIZING);
+    continuousRecording = true;
+
+    decision.reset();
+
+    // DTMF decodes alongside the wake word on the same capture
+    keySequence = "";
+    dtmfDetector->resetStream();
+    MIC_setListener(DTMFDetector::onCapture, dtmfDetector);
+    tryStart();
+}
+
+void WakeWordState::tryStart() {
+    // Microphone bias is still settling right after boot
+    if (!MIC_isReady()) return;
+
+    // Allocate 4 buffers for wake word (1 second each)
+    if (allocateWakeWordBuffers()) {
+        startRecording();
+        wakePipeline.start();
+        ui->status(LcdTimeDisplay::STATUS_WAITING);
+    } else {
+        Serial.println("ERROR: Failed to allocate wake word buffers!");
+        ui->toast("Buffer Error!", BUFFER_RETRY_MS);
+        retryTimer = scheduler.after(BUFFER_RETRY_MS, [](void*) {});
+    }
+}
+
+void WakeWordState::tick() {
+    if (!buffersAllocated) {
+        if (!scheduler.isPending(retryTimer)) tryStart();
+        return;
+    }
+
+    // Keys come from capture already done, so act on them first
+    char key = dtmfDetector->takeKey();
+    if (key != '\0' && onKey(key)) return;
+
+    if (Serial.available() > 0) onCommand(Serial.read());
+
+    runWakeWord();
+}
+
+void WakeWordState::exit() {
+    wakePipeline.stop();
+    wakePipeline.printStats("wake");
+    scheduler.cancel(retryTimer);
+    retryTimer = Scheduler::INVALID_TIMER;
+    scheduler.cancel(keyTimer);
+    keyTimer = Scheduler::INVALID_TIMER;
+    MIC_setListener(nullptr, nullptr);
+}
+
+void WakeWordState::onKeyTimeout(void* context) {
+    WakeWordState* self = static_cast<WakeWordState*>(context);
+    Serial.printf("[DTMF] Sequence %s timed out\n", self->keySequence.c_str());
+    self->keySequence = "";
+}
+
+// Returns true when the key completed a shortcut and a transition is queued
+bool WakeWordState::onKey(char key) {
+    Serial.printf("[DTMF] Key %c while listening\n", key);
+
+    if (key == '*') {
+        keySequence = "*";
+    } else if (keySequence.length() > 0) {
+        keySequence += key;
+    } else {
+        return false;  // Not inside a sequence
+    }
+
+    scheduler.cancel(keyTimer);
+    keyTimer = Scheduler::INVALID_TIMER;
+    if (key != '#') {
+        keyTimer = scheduler.after(KEY_SEQUENCE_TIMEOUT_MS, onKeyTimeout, this);
+        return false;
+    }
+
+    String code = keySequence;
+    keySequence = "";
+
+    for (int i = 0; i < KEY_SHORTCUT_COUNT; i++) {
+        if (code != KEY_SHORTCUTS[i].code) continue;
+
+        // The laser result lives in the capture buffers; park the capture
+        // core before reading it
+        wakePipeline.stop();
+        detector->publishSpectra(detector->getSpectraStart());
+
+        // Tones can be injected too; hold them to the same laser check as speech
+        if (defenceSet && laserCalibrated) {
+            const LaserAttackDetector::DetectionResult& result = laserDetector->getResult();
+            if (result.attackDetected && result.confidence > 60) {
+                laserDetector->printResults(result);
+                Serial.println("⚠️  SECURITY ALERT: Keypad shortcut ignored!");
+                ui->toast(LcdTimeDisplay::STATUS_LASER_ALERT, 2000, UiService::PRIORITY_ALERT);
                 startRecording();
-                m_states = WAKE_WORD_STATE;
-                lcdDisplay->updateStatus(LcdTimeDisplay::STATUS_WAITING);
+                wakePipeline.start();
+                return false;
             }
-            break;
-            
-        case WAKE_WORD_STATE:
-            Run_WakeWord();
-            break;
-            
-        case WIT_STATE:
-            Run_Wit();
-            break;
-            
-        case PROCESS_INTENT:
-            handleIntentProcessing();
-            break;
-            
-        case DTMF_INPUT_STATE:
-            Run_DTMFInput();
-            break;
+        }
 
-        case VERIFY_CODE_INPUT_STATE:
-            Run_VerificationCodeInput();
-            break;
-        
-        default:
-            break;
+        Serial.printf("[DTMF] Shortcut %s\n", code.c_str());
+        ui->toast(code.c_str(), 500);
+
+        continuousRecording = false;
+        acknowledgeData();
+        freeBuffers();
+        p_states = KEY_SHORTCUTS[i].action;
+        machine.transitionTo(&processIntentState);
+        return true;
     }
-    Run_WifiConnectionCheck();
+
+    Serial.printf("[DTMF] Unknown shortcut %s\n", code.c_str());
+    return false;
 }
 
-void Run_DTMFInput() {
-    static bool dtmfInitialized = false;
-    static unsigned long lastUpdateTime = 0;
-    
-    if (!dtmfInitialized) {
-        freeBuffers();
-        checkMemory("After freeing wake word buffers");
-        
-        if (!dtmfDetector->allocateBuffer()) {
-            Serial.println("[DTMF] Failed to allocate buffer!");
-            lcdDisplay->updateStatus("DTMF Buf Err!");
-            delay(2000);
-            m_states = START_WAKE_WORD_STATE;
-            return;
-        }
-        
-        dtmfDetector->calibrateDCOffset(micPin1);
-        dtmfDetector->resetTimeEntry();
-        lcdDisplay->updateStatus(dtmfDetector->getTimeDisplay().c_str());
-        
-        dtmfInitialized = true;
-        Serial.println("\n[DTMF] Ready for time input:");
-        Serial.println("  Digits 0-9: Enter time");
-        Serial.println("  A: Toggle AM/PM");
-        Serial.println("  C: Confirm");
-        Serial.println("  D: Backspace");
+// Debug commands; Serial input is read here only, never on the capture core
+void WakeWordState::onCommand(char command) {
+    wakePipeline.stop();
+    MIC_command(command);
+    wakePipeline.start();
+}
+
+void WakeWordState::runWakeWord() {
+    // Capture and features run on the other core; this only scores
+    const WakePipeline::Window* window = wakePipeline.poll();
+    if (!window) return;
+
+    unsigned long start_time = millis();
+    float score = detector->scoreFeatures(&window->features[0][0], window->newFrames);
+    unsigned long inference_time = millis() - start_time;
+
+    decision.setMode(defenceSet ? WakeDecision::STRICT : WakeDecision::RELAXED);
+    bool triggered = decision.update(score, millis());
+
+    Serial.printf("Detection Score: %.1f%% (avg %.1f%%, peak %.1f%%, %d/%d %s) %d/%d frames %lums",
+                  score * 100, decision.getAverage() * 100, decision.getPeak() * 100,
+                  decision.getHits(), decision.getMode().required, decision.getMode().name,
+                  window->newFrames, N_FRAMES, inference_time);
+
+    if (!triggered) {
+        Serial.println(" ❌ Not detected");
+        return;
     }
-    
-    char detected = dtmfDetector->recordAndDetect(micPin1);
-    
-    if (detected != '\0') {
-        Serial.printf("[DTMF] Detected: %c\n", detected);
-        bool isComplete = dtmfDetector->processTimeEntry(detected);
-        lcdDisplay->updateStatus(dtmfDetector->getTimeDisplay().c_str());
-        
-        if (isComplete) {
-            // Get the final time value (12-hour format with AM/PM)
-            reminderTime = dtmfDetector->getTimeValue();
-            Serial.printf("[DTMF] Reminder set for: %s\n", reminderTime.c_str());
-            
-            // Show confirmation with AM/PM
-            String confirmMsg = "Set: " + reminderTime;
-            lcdDisplay->updateStatus(confirmMsg.c_str());
-            
-            dtmfDetector->freeBuffer();
-            dtmfInitialized = false;
-            checkMemory("After DTMF cleanup");
-            
-            delay(3000);
-            m_states = START_WAKE_WORD_STATE;
+
+    Serial.println(" 😊 WAKE WORD DETECTED!");
+    ui->toast(LcdTimeDisplay::STATUS_DETECTED, 500);
+
+    // The capture buffers are only safe to read once the capture core has
+    // parked; they may have moved on by a hop since the window that fired
+    wakePipeline.stop();
+    wakePipeline.printStats("wake");
+    continuousRecording = false;
+
+    // Laser checks compare the raw mics over the frames that fired, which
+    // the feature pass already stored
+    if (!detector->publishSpectra(window->spectraStart)) {
+        Serial.println("[PIPE] Spectra of the scored window already overwritten");
+    }
+    bool audioVerified = verifyLaser();
+    if (!audioVerified && defenceSet) {
+        // Attack detected - restart wake word detection
+        ui->toast(LcdTimeDisplay::STATUS_LASER_ALERT, 2000, UiService::PRIORITY_ALERT);
+        Serial.println("Restarting wake word detection...");
+        continuousRecording = true;
+        acknowledgeData();
+        startRecording();
+        wakePipeline.start();
+        ui->status(LcdTimeDisplay::STATUS_WAITING);
+        return;
+    }
+    else if(!audioVerified && !defenceSet){
+        ui->toast("Ok Attacker :(", 1000);
+    }
+    freeBuffers();
+    startRecording_wit();
+    machine.transitionTo(&witState);
+}
+
+bool WakeWordState::verifyLaser() {
+    ui->status(LcdTimeDisplay::STATUS_LASER_CHECK);
+
+    // Auto-calibrate on first successful wake word
+    if (!laserCalibrated) {
+        Serial.println("\nFirst wake word - calibrating detector...");
+        ui->toast("Calibrating...", 1000);
+        laserDetector->calibrate();
+        laserCalibrated = true;
+
+        // On first run, assume it's legitimate (for calibration)
+        Serial.println("Calibration complete - proceeding normally");
+        return true;
+    }
+
+    Serial.println("\nChecking for laser attacks...");
+
+    // Statistics were accumulated while the buffer was recorded
+    const LaserAttackDetector::DetectionResult& result = laserDetector->getResult();
+
+    laserDetector->printResults(result);
+
+    if (result.attackDetected && result.confidence > 60) { // Only block high confidence attacks
+        Serial.println("⚠️  SECURITY ALERT: Probable laser attack!");
+        Serial.println("Recording may be compromised. Ignoring wake word.");
+        return false;
+    }
+
+    Serial.println("✅ Audio verified - proceeding to Wit.ai");
+    return true;
+}
+
+
+// ============================================================================
+// WIT
+// ============================================================================
+
+void WitState::enter() {
+    ui->status("Listening...");
+}
+
+void WitState::tick() {
+    // Allocate only ringBuffer1 for Wit.ai (3 seconds)
+    if (!buffersAllocated) {
+        if (scheduler.isPending(retryTimer)) return;
+        if (!allocateWitBuffers()) {
+            Serial.println("ERROR: Failed to allocate Wit.ai buffers!");
+            ui->toast("Buffer Error!", BUFFER_RETRY_MS);
+            retryTimer = scheduler.after(BUFFER_RETRY_MS, [](void*) {});
+            return;
         }
     }
-    
-    if (millis() - lastUpdateTime > 500) {
-        lcdDisplay->updateStatus(dtmfDetector->getTimeDisplay().c_str());
-        lastUpdateTime = millis();
+
+    if (WIT_loop()) {
+        WIT_acknowledgeData();
+        freeBuffers();
+        Serial.println("\nReady to process");
+        ui->toast(LcdTimeDisplay::STATUS_INTENT_READY, 1500);
+        checkMemory("After Wit.ai processing");
+        machine.transitionTo(&processIntentState);
     }
 }
 
-void handleIntentProcessing() {
-    
+void WitState::exit() {
+    scheduler.cancel(retryTimer);
+    retryTimer = Scheduler::INVALID_TIMER;
+}
+
+
+// ============================================================================
+// PROCESS_INTENT
+// ============================================================================
+
+void ProcessIntentState::enter() {
+    waitingForMotor = false;
+
     switch(p_states)
     {
         case EMPTY:
             Serial.println("Nothing to process...");
-            lcdDisplay->updateStatus("Empty");
-            delay(2000);
-            m_states = START_WAKE_WORD_STATE;
+            ui->toast("Empty", 2000);
+            machine.transitionTo(&wakeWordState);
             break;
-            
+
         case MORNING_PILL:
             Serial.println("Processing MORNING PILL reminder");
-            lcdDisplay->updateStatus(LcdTimeDisplay::STATUS_MORNING_PILL);
-            
-            // Simulate processing
+            ui->status(LcdTimeDisplay::STATUS_MORNING_PILL);
+
+            // Starts the wheel moving; tick() waits for it to finish
             handleMorningCommand();
-            
-            lcdDisplay->updateStatus("Pill Set: AM");
-            Serial.println("Morning pill reminder has been set");
-            delay(2000);
-            
-            m_states = START_WAKE_WORD_STATE;
+            motorDoneMessage = "Pill Set: AM";
+            waitingForMotor = true;
             break;
-        
+
         case EVENING_PILL:
             Serial.println("Processing EVENING PILL reminder");
-            lcdDisplay->updateStatus(LcdTimeDisplay::STATUS_EVENING_PILL);
-        
+            ui->status(LcdTimeDisplay::STATUS_EVENING_PILL);
+
             handleNightCommand();
-            
-            lcdDisplay->updateStatus("Pill Set: PM");
-            Serial.println("Evening pill reminder has been set");
-            delay(2000);
-            
-            m_states = START_WAKE_WORD_STATE;
+            motorDoneMessage = "Pill Set: PM";
+            waitingForMotor = true;
             break;
-        
+
         case VERIFY_ME:
             Serial.println("Processing VERIFY ME command");
-            lcdDisplay->updateStatus(LcdTimeDisplay::STATUS_VERIFYING);
-            
+            ui->status(LcdTimeDisplay::STATUS_VERIFYING);
+
             Serial.println("[VERIFY] Sending verification code via WhatsApp...");
-            lcdDisplay->updateStatus("Sending code...");
-            
+            ui->status("Sending code...");
+
             if (whatsappVerifier->generateAndSendCode()) {
                 Serial.println("[VERIFY] WhatsApp message sent successfully!");
-                lcdDisplay->updateStatus("Check WhatsApp!");
-                delay(2500);
-                
-                lcdDisplay->updateStatus("Enter 4 digits");
-                delay(2000);
-                
-                m_states = VERIFY_CODE_INPUT_STATE;
+                // The code prompt is the status line; a toast here would
+                // hide it while digits are already being accepted
+                machine.transitionTo(&verifyCodeState);
             } else {
                 Serial.println("[VERIFY] Failed to send WhatsApp message!");
                 Serial.println("[VERIFY] Check your CallMeBot API key and phone number");
-                lcdDisplay->updateStatus("WhatsApp Failed!");
-                delay(3000);
-                
-                lcdDisplay->updateStatus("Check API key");
-                delay(2000);
-                
-                m_states = START_WAKE_WORD_STATE;
+                ui->toast("WhatsApp Failed!", 3000);
+                ui->toast("Check API key", 2000);
+                machine.transitionTo(&wakeWordState);
             }
             break;
-        
+
         case SET_REMINDER:
             Serial.println("Processing SET REMINDER command");
-            lcdDisplay->updateStatus(LcdTimeDisplay::STATUS_SET_REMINDER);
-            
-            delay(1000);
-            lcdDisplay->updateStatus("Time Input");
-            delay(500);
-            m_states = DTMF_INPUT_STATE;
+            machine.transitionTo(&dtmfInputState);     // Prompts on the status line
             break;
-        
+
         case STOP_DEFENCE:
             Serial.println("Processing STOP DEFENCE command");
             defenceSet = false;
-            lcdDisplay->updateStatus("No Security :(");
-            delay(2000);
-            m_states = START_WAKE_WORD_STATE;
+            ui->toast("No Security :(", 2000);
+            machine.transitionTo(&wakeWordState);
             break;
-        
+
         default:
             Serial.println("Unknown intent - returning to wake word");
-            lcdDisplay->updateStatus("Unknown Cmd");
-            delay(2000);
-            m_states = START_WAKE_WORD_STATE;
+            ui->toast("Unknown Cmd", 2000);
+            machine.transitionTo(&wakeWordState);
             break;
     }
 }
 
-void Run_VerificationCodeInput() {
-    static bool verificationInitialized = false;
-    static unsigned long lastUpdateTime = 0;
-    static unsigned long lastBlinkTime = 0;
-    static bool showCursor = true;
-    static int attemptCount = 0;
-    const int MAX_ATTEMPTS = 3;
-    
-    if (!verificationInitialized) {
-        freeBuffers();
-        checkMemory("After freeing buffers for verification");
-        
-        // Allocate DTMF buffer
-        if (!dtmfDetector->allocateBuffer()) {
-            Serial.println("[VERIFY] Failed to allocate DTMF buffer!");
-            lcdDisplay->updateStatus("Buffer Error!");
-            delay(2000);
-            m_states = START_WAKE_WORD_STATE;
-            return;
+void ProcessIntentState::tick() {
+    if (waitingForMotor && !MOTOR_isBusy()) {
+        waitingForMotor = false;
+        ui->toast(motorDoneMessage, 2000);
+        Serial.printf("%s - reminder has been set\n", motorDoneMessage);
+        machine.transitionTo(&wakeWordState);
+    }
+}
+
+
+// ============================================================================
+// DTMF_INPUT
+// ============================================================================
+
+void DtmfInputState::enter() {
+    freeBuffers();
+    checkMemory("After freeing wake word buffers");
+
+    // Decodes straight off the shared capture; nothing to allocate or calibrate
+    dtmfDetector->resetStream();
+    MIC_setListener(DTMFDetector::onCapture, dtmfDetector);
+    MIC_drain();
+    dtmfDetector->resetTimeEntry();
+    ui->status(dtmfDetector->getTimeDisplay().c_str());
+
+    Serial.println("\n[DTMF] Ready for time input:");
+    Serial.println("  Digits 0-9: Enter time");
+    Serial.println("  A: Toggle AM/PM");
+    Serial.println("  C: Confirm");
+    Serial.println("  D: Backspace");
+
+    refreshTimer = scheduler.every(500, onRefresh, this);
+}
+
+void DtmfInputState::onRefresh(void* context) {
+    ui->status(dtmfDetector->getTimeDisplay().c_str());
+}
+
+void DtmfInputState::tick() {
+    MIC_stream();
+    char detected = dtmfDetector->takeKey();
+
+    if (detected != '\0') {
+        Serial.printf("[DTMF] Detected: %c\n", detected);
+        bool isComplete = dtmfDetector->processTimeEntry(detected);
+        ui->status(dtmfDetector->getTimeDisplay().c_str());
+
+        if (isComplete) {
+            // Get the final time value (12-hour format with AM/PM)
+            reminderTime = dtmfDetector->getTimeValue();
+            Serial.printf("[DTMF] Reminder set for: %s\n", reminderTime.c_str());
+
+            // Show confirmation with AM/PM
+            String confirmMsg = "Set: " + reminderTime;
+            ui->toast(confirmMsg.c_str(), 3000);
+            machine.transitionTo(&wakeWordState);
         }
-        
-        dtmfDetector->calibrateDCOffset(micPin1);
-        whatsappVerifier->resetCodeEntry();
-        String display = "Code: " + whatsappVerifier->getCodeDisplay();
-        lcdDisplay->updateStatus(display.c_str());
-        
-        verificationInitialized = true;
-        attemptCount = 0;
-        
-        Serial.println("\n[VERIFY] Ready for verification code input:");
-        Serial.println("  Enter 4-digit code from WhatsApp");
-        Serial.println("  C: Confirm");
-        Serial.println("  D: Backspace");
-        Serial.println("  Waiting for DTMF tones...");
     }
-    
+}
+
+void DtmfInputState::exit() {
+    scheduler.cancel(refreshTimer);
+    refreshTimer = Scheduler::INVALID_TIMER;
+    MIC_setListener(nullptr, nullptr);
+}
+
+
+// ============================================================================
+// VERIFY_CODE_INPUT
+// ============================================================================
+
+// "WhatsApp: 12__" doubles as the prompt: where the code is, how many digits
+void VerifyCodeState::showCode(bool withCursor) {
+    String display = "WhatsApp: " + whatsappVerifier->getCodeDisplay();
+    if (withCursor && !whatsappVerifier->isCodeComplete()) {
+        display += "_";
+    }
+    ui->status(display.c_str());
+}
+
+void VerifyCodeState::onBlink(void* context) {
+    VerifyCodeState* self = static_cast<VerifyCodeState*>(context);
+    self->showCursor = !self->showCursor;
+    self->showCode(self->showCursor);
+}
+
+void VerifyCodeState::enter() {
+    freeBuffers();
+    checkMemory("After freeing buffers for verification");
+
+    dtmfDetector->resetStream();
+    MIC_setListener(DTMFDetector::onCapture, dtmfDetector);
+    MIC_drain();
+    whatsappVerifier->resetCodeEntry();
+    showCode(false);
+
+    attemptCount = 0;
+    showCursor = true;
+
+    Serial.println("\n[VERIFY] Ready for verification code input:");
+    Serial.println("  Enter 4-digit code from WhatsApp");
+    Serial.println("  C: Confirm");
+    Serial.println("  D: Backspace");
+    Serial.println("  Waiting for DTMF tones...");
+
+    blinkTimer = scheduler.every(500, onBlink, this);
+}
+
+void VerifyCodeState::tick() {
     if (whatsappVerifier->isCodeExpired()) {
         Serial.println("[VERIFY] Code expired!");
-        lcdDisplay->updateStatus("Code Expired!");
-        delay(2000);
-        
-        dtmfDetector->freeBuffer();
-        verificationInitialized = false;
-        m_states = START_WAKE_WORD_STATE;
+        ui->toast("Code Expired!", 2000);
+        machine.transitionTo(&wakeWordState);
         return;
     }
-    
-    char detected = dtmfDetector->recordAndDetect(micPin1);
-    
+
+    MIC_stream();
+    char detected = dtmfDetector->takeKey();
+
     if (detected != '\0') {
         Serial.printf("[VERIFY] DTMF Detected: %c\n", detected);
-        
+
         bool isComplete = whatsappVerifier->processCodeEntry(detected);
-        
-        String display = "Code: " + whatsappVerifier->getCodeDisplay();
-        lcdDisplay->updateStatus(display.c_str());
-        
+        showCode(false);
+
         if (isComplete) {
             if (whatsappVerifier->verifyCode()) {
                 Serial.println("[VERIFY] ✓ Identity verified via WhatsApp!");
-                lcdDisplay->updateStatus("Verified! ✓");
-                
+                ui->toast("Verified! ✓", 3000);
+
                 // Here we can set a flag for verified user
                 // isUserVerified = true;
-                
-                delay(3000);
-                
-                lcdDisplay->updateStatus("Welcome Back!");
-                delay(2000);
+
+                ui->toast("Welcome Back!", 2000);
             } else {
                 attemptCount++;
-                Serial.printf("[VERIFY] ✗ Wrong code! Attempt %d/%d\n", 
+                Serial.printf("[VERIFY] ✗ Wrong code! Attempt %d/%d\n",
                              attemptCount, MAX_ATTEMPTS);
-                
-                if (attemptCount >= MAX_ATTEMPTS) {
-                    lcdDisplay->updateStatus("Max attempts!");
-                    delay(3000);
-                    
-                    dtmfDetector->freeBuffer();
-                    verificationInitialized = false;
-                    m_states = START_WAKE_WORD_STATE;
-                    return;
-                } else {
-                    lcdDisplay->updateStatus("Wrong! Try again");
-                    delay(2000);
+
+                if (attemptCount < MAX_ATTEMPTS) {
+                    ui->toast("Wrong! Try again", 2000);
                     whatsappVerifier->resetCodeEntry();
-                    display = "Code: " + whatsappVerifier->getCodeDisplay();
-                    lcdDisplay->updateStatus(display.c_str());
+                    showCode(false);
                     return;  // Don't exit, allow retry
                 }
+                ui->toast("Max attempts!", 3000);
             }
-            
-            // Cleanup after verification (success or max attempts)
-            dtmfDetector->freeBuffer();
-            verificationInitialized = false;
-            checkMemory("After verification cleanup");
-            m_states = START_WAKE_WORD_STATE;
-        }
-    }
-    
-    if (millis() - lastBlinkTime > 500) {
-        showCursor = !showCursor;
-        String display = "Code: " + whatsappVerifier->getCodeDisplay();
-        if (showCursor && !whatsappVerifier->isCodeComplete()) {
-            display += "_";
-        }
-        lcdDisplay->updateStatus(display.c_str());
-        lastBlinkTime = millis();
-    }
-}
 
-void Run_Wit() {
-    
-    lcdDisplay->updateStatus("Listening...");
-    
-    // Allocate only ringBuffer1 for Wit.ai (3 seconds)
-    if (!buffersAllocated) {
-        if (!allocateWitBuffers()) {
-            Serial.println("ERROR: Failed to allocate Wit.ai buffers!");
-            lcdDisplay->updateStatus("Buffer Error!");
-            delay(2000);
-            return;
+            // Verification finished (success or max attempts)
+            machine.transitionTo(&wakeWordState);
         }
     }
-    
-    if (WIT_loop()) {
-        WIT_acknowledgeData();
-        freeBuffers();
-        m_states = PROCESS_INTENT;
-        Serial.println("\nReady to process");
-        lcdDisplay->updateStatus(LcdTimeDisplay::STATUS_INTENT_READY);
-        checkMemory("After Wit.ai processing");
-        delay(1500);
-    }
 }
 
-void Run_Cleanup() {
-    freeBuffers();
-    checkMemory("After cleanup");
+void VerifyCodeState::exit() {
+    scheduler.cancel(blinkTimer);
+    blinkTimer = Scheduler::INVALID_TIMER;
+    MIC_setListener(nullptr, nullptr);
 }
 
-void Run_WakeWord() {
-    // Allocate 4 buffers for wake word (1 second each)
-    if (!buffersAllocated) {
-        if (!allocateWakeWordBuffers()) {
-            Serial.println("ERROR: Failed to allocate wake word buffers!");
-            lcdDisplay->updateStatus("Buffer Error!");
-            delay(2000);
-            return;
-        }
-    }
-    
-    if (MIC_loop()) {
-        unsigned long start_time = millis();
-        float score = detector->detectWakeWord(pitchBuffer1, BUFFER_SIZE);
-        unsigned long inference_time = millis() - start_time;
-        
-        Serial.print("Detection Score: ");
-        Serial.print(score * 100, 1);
-        Serial.print("%");
-
-        if(defenceSet) confidence = 0.999f;
-        else confidence = 0.90f;
-        
-        if (score > confidence) {
-            Serial.println(" 😊 WAKE WORD DETECTED!");
-            lcdDisplay->updateStatus(LcdTimeDisplay::STATUS_DETECTED);
-            delay(500);  
-            
-            continuousRecording = false;  
-            if (!Run_VerifyLaser() && defenceSet) {
-                // Attack detected - restart wake word detection
-                lcdDisplay->updateStatus(LcdTimeDisplay::STATUS_LASER_ALERT);
-                Serial.println("Restarting wake word detection...");
-                delay(2000);  
-                continuousRecording = true;
-                acknowledgeData();
-                startRecording();
-                lcdDisplay->updateStatus(LcdTimeDisplay::STATUS_WAITING);
-                return;  
-            }
-            else if(!Run_VerifyLaser() && !defenceSet){
-                lcdDisplay->updateStatus("Ok Attacker :(");
-                delay(1000);  
-            }
-            freeBuffers();  
-            startRecording_wit();
-            m_states = WIT_STATE;
-        } 
 
-
-        
-        else {
-            Serial.println(" ❌ Not detected");
-            if (continuousRecording && !shouldRecord) {
-                startRecording();
-            }
-        }
-        
-        acknowledgeData();
-    }
-}
-
-bool Run_VerifyLaser() {
-    static bool firstRun = true;
-    
-    lcdDisplay->updateStatus(LcdTimeDisplay::STATUS_LASER_CHECK);
-    
-    // Auto-calibrate on first successful wake word
-    if (firstRun) {
-        Serial.println("\nFirst wake word - calibrating detector...");
-        lcdDisplay->updateStatus("Calibrating...");
-        laserDetector->calibrate(pitchBuffer1, pitchBuffer2, BUFFER_SIZE);
-        firstRun = false;
-        
-        // On first run, assume it's legitimate (for calibration)
-        Serial.println("Calibration complete - proceeding normally");
-        delay(1000);
-        return true;
-    }
-    
-    Serial.println("\nChecking for laser attacks...");
-    
-    LaserAttackDetector::DetectionResult result = 
-        laserDetector->detectAttack(pitchBuffer1, pitchBuffer2, BUFFER_SIZE);
-    
-    laserDetector->printResults(result);
-    
-    if (result.attackDetected && result.confidence > 60) { // Only block high confidence attacks
-        Serial.println("⚠️  SECURITY ALERT: Probable laser attack!");
-        Serial.println("Recording may be compromised. Ignoring wake word.");
-        return false;
-    }
-    
-    Serial.println("✅ Audio verified - proceeding to Wit.ai");
-    return true;
-}
+// ============================================================================
+// Background services
+// ============================================================================
 
 void Run_WifiConnectionCheck(){
-    static bool wasConnected = false;
-    
-    if (WiFi.status() != WL_CONNECTED) {
-        if (wasConnected) {  
-            Serial.println("WiFi disconnected! Reconnecting...");
-            lcdDisplay->updateStatus("WiFi Lost!");
-            wasConnected = false;
-        }
-        connectWiFi();
-    } else {
-        if (!wasConnected) {
-            wasConnected = true;
-        }
-    }
-}
+    wifiManager->loop();
 
-void wifiScanner(){
-    Serial.println("Scan start");
- 
-    // WiFi.scanNetworks will return the number of networks found.
-    int n = WiFi.scanNetworks();
-    Serial.println("Scan done");
-    if (n == 0) {
-        Serial.println("no networks found");
-    } else {
-        Serial.print(n);
-        Serial.println(" networks found");
-        Serial.println("Nr | SSID                             | RSSI | CH | Encryption");
-        for (int i = 0; i < n; ++i) {
-            // Print SSID and RSSI for each network found
-            Serial.printf("%2d",i + 1);
-            Serial.print(" | ");
-            Serial.printf("%-32.32s", WiFi.SSID(i).c_str());
-            Serial.print(" | ");
-            Serial.printf("%4d", WiFi.RSSI(i));
-            Serial.print(" | ");
-            Serial.printf("%2d", WiFi.channel(i));
-            Serial.print(" | ");
-            switch (WiFi.encryptionType(i))
-            {
-            case WIFI_AUTH_OPEN:
-                Serial.print("open");
-                break;
-            case WIFI_AUTH_WEP:
-                Serial.print("WEP");
-                break;
-            case WIFI_AUTH_WPA_PSK:
-                Serial.print("WPA");
-                break;
-            case WIFI_AUTH_WPA2_PSK:
-                Serial.print("WPA2");
-                break;
-            case WIFI_AUTH_WPA_WPA2_PSK:
-                Serial.print("WPA+WPA2");
-                break;
-            case WIFI_AUTH_WPA2_ENTERPRISE:
-                Serial.print("WPA2-EAP");
-                break;
-            case WIFI_AUTH_WPA3_PSK:
-                Serial.print("WPA3");
-                break;
-            case WIFI_AUTH_WPA2_WPA3_PSK:
-                Serial.print("WPA2+WPA3");
-                break;
-            case WIFI_AUTH_WAPI_PSK:
-                Serial.print("WAPI");
-                break;
-            default:
-                Serial.print("unknown");
-            }
-            Serial.println();
-            delay(10);
-        }
+    if (wifiManager->justDisconnected()) {
+        Serial.println("WiFi disconnected! Reconnecting...");
+        ui->status("WiFi Lost!");
     }
-    Serial.println("");
- 
-    // Delete the scan result to free memory for code below.
-    WiFi.scanDelete();
-}
 
-void connectWiFi() {
-    Serial.print("Scanning WiFi...");
-    lcdDisplay->updateStatus("Scanning WiFi...");
-    wifiScanner();
-
-    Serial.print("Connecting to WiFi");
-    lcdDisplay->updateStatus(LcdTimeDisplay::STATUS_WIFI_CONNECTING);
-    WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
-    
-    int attempts = 0;
-    while (WiFi.status() != WL_CONNECTED && attempts < 20) {
-        delay(500);
-        Serial.print(".");
-        attempts++;
-        
-        // Animate dots on LCD
-        String dots = "";
-        for(int i = 0; i < (attempts % 4); i++) {
-            dots += ".";
-        }
-        String status = String("WiFi Connect") + dots;
-        lcdDisplay->updateStatus(status.c_str());
-    }
-    
-    if (WiFi.status() == WL_CONNECTED) {
+    if (wifiManager->justConnected()) {
         Serial.println("\nWiFi connected!");
         Serial.print("IP: ");
         Serial.println(WiFi.localIP());
-        
-        lcdDisplay->updateStatus(LcdTimeDisplay::STATUS_WIFI_CONNECTED);
-        delay(1000);
-        
+        ui->status(LcdTimeDisplay::STATUS_WIFI_CONNECTED);
+
         // Sync time after WiFi connection
         Serial.println("Syncing time with NTP server...");
-        lcdDisplay->updateStatus("Time Sync...");
-        lcdDisplay->forceTimeSync();
-        delay(1000);
-        
-        m_states = WAKE_WORD_STATE;
-        lcdDisplay->updateStatus(LcdTimeDisplay::STATUS_WAITING);
-    } else {
-        Serial.println("\nWiFi connection FAILED!");
-        lcdDisplay->updateStatus("WiFi Failed!");
+        ui->status("Time Sync...");
+        timeService->requestSync();
+
+        if (machine.isIn(&wakeWordState)) {
+            ui->status(LcdTimeDisplay::STATUS_WAITING);
+        }
     }
-}
\ No newline at end of file
+}
@@ -78,24 +78,22 @@ void releaseMotor() {
     digitalWrite(IN4, LOW);
 }
 
-// Step the motor a given number of half-steps in a direction (+1 or -1)
+// ---- Pending motion, advanced by MOTOR_tick() ----
+int stepsRemaining = 0;
+int stepDirection  = 1;
+unsigned long lastStepTime = 0;
+
+// Queue a given number of half-steps in a direction (+1 or -1). A move
+// still in progress is folded in, so the wheel ends up where both moves
+// together put it (currentChamber already assumes that).
 void stepMotor(int stepsToTake, int direction) {
     if (direction == 0 || stepsToTake <= 0) return;
 
-    int dir = (direction > 0) ? 1 : -1;
+    int pending = stepsRemaining * stepDirection;
+    int total   = pending + ((direction > 0) ? stepsToTake : -stepsToTake);
 
-    for (int i = 0; i < stepsToTake; i++) {
-        setStep(stepSequence[stepIndex][0],
-                stepSequence[stepIndex][1],
-                stepSequence[stepIndex][2],
-                stepSequence[stepIndex][3]);
-
-        stepIndex += dir;
-        if (stepIndex >= 8) stepIndex = 0;
-        if (stepIndex < 0)  stepIndex = 7;
-
-        delay(STEP_DELAY_MS);
-    }
+    stepDirection  = (total >= 0) ? 1 : -1;
+    stepsRemaining = abs(total);
 }
 
 // Move wheel so that targetChamber (0..14) is aligned
@@ -238,6 +236,30 @@ void MOTOR_setup() {
     moveToEmpty();
 }
 
+// Advance at most one half-step per STEP_DELAY_MS; never waits
+void MOTOR_tick() {
+    if (stepsRemaining <= 0) return;
+
+    unsigned long now = millis();
+    if (now - lastStepTime < (unsigned long)STEP_DELAY_MS) return;
+    lastStepTime = now;
+
+    setStep(stepSequence[stepIndex][0],
+            stepSequence[stepIndex][1],
+            stepSequence[stepIndex][2],
+            stepSequence[stepIndex][3]);
+
+    stepIndex += stepDirection;
+    if (stepIndex >= 8) stepIndex = 0;
+    if (stepIndex < 0)  stepIndex = 7;
+
+    stepsRemaining--;
+}
+
+bool MOTOR_isBusy() {
+    return stepsRemaining > 0;
+}
+
 // void MOTOR_loop() {
 //     if (Serial.available()) {
 //         char c = Serial.read();
@@ -0,0 +1,120 @@
+// ============================================================================
+// Arduino.h - Host stand-in for the Arduino core, native test builds only
+// ============================================================================
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// Just enough of the ESP32 Arduino core for the portable modules to build
+// and run on the host: a real-time clock, Serial to stdout, String, and the
+// FreeRTOS subset the tasks use (HostRtos.h, on std::thread).
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "HostRtos.h"
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+#define TWO_PI 6.283185307179586476925286766559
+
+#define A0 1
+#define A1 2
+
+// ESP32-S3: GPIO1-10 are ADC1 channels 0-9
+#define digitalPinToAnalogChannel(pin) (((pin) >= 1 && (pin) <= 10) ? (pin) - 1 : -1)
+
+using std::min;
+using std::max;
+
+inline uint32_t micros() {
+    static const auto origin = std::chrono::steady_clock::now();
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - origin).count();
+}
+
+inline uint32_t millis() {
+    return micros() / 1000;
+}
+
+inline void delay(uint32_t ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+inline void delayMicroseconds(uint32_t us) {
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+class String : public std::string {
+public:
+    String(const char* text = "") : std::string(text ? text : "") {}
+    String(const std::string& text) : std::string(text) {}
+    explicit String(char c) : std::string(1, c) {}
+    explicit String(int value) : std::string(std::to_string(value)) {}
+
+    String& operator+=(const String& other) { append(other); return *this; }
+    String& operator+=(const char* other) { append(other); return *this; }
+    String& operator+=(char c) { push_back(c); return *this; }
+};
+
+// Writes to stdout; HOST_QUIET_SERIAL=1 in the environment silences it
+class HostSerial {
+private:
+    bool quiet() const {
+        static const bool muted = getenv("HOST_QUIET_SERIAL") != nullptr;
+        return muted;
+    }
+
+public:
+    void begin(unsigned long) {}
+    explicit operator bool() const { return true; }
+    int available() { return 0; }
+    int read() { return -1; }
+    void flush() { fflush(stdout); }
+
+    template <typename... Args>
+    void printf(const char* format, Args... args) {
+        if (!quiet()) ::printf(format, args...);
+    }
+
+    void print(const char* text) { if (!quiet()) fputs(text, stdout); }
+    void print(const String& text) { print(text.c_str()); }
+    void print(char c) { if (!quiet()) putchar(c); }
+    void print(long value) { printf("%ld", value); }
+    void print(int value) { print((long)value); }
+    void print(unsigned long value) { printf("%lu", value); }
+    void print(unsigned int value) { print((unsigned long)value); }
+    void print(double value, int digits = 2) { printf("%.*f", digits, value); }
+
+    template <typename T>
+    void println(T value) { print(value); println(); }
+    void println(double value, int digits) { print(value, digits); println(); }
+    void println() { print("\n"); }
+
+    size_t write(uint8_t byte) { if (!quiet()) putchar(byte); return 1; }
+    size_t write(const uint8_t* data, size_t length) {
+        if (!quiet()) fwrite(data, 1, length, stdout);
+        return length;
+    }
+};
+
+inline HostSerial Serial;
+
+class HostEsp {
+public:
+    uint32_t getFreeHeap() { return 0; }
+    uint32_t getMinFreeHeap() { return 0; }
+};
+
+inline HostEsp ESP;
+
+#endif
@@ -0,0 +1,211 @@
+// ============================================================================
+// HostRtos.h - FreeRTOS subset on std::thread, native test builds only
+// ============================================================================
+#ifndef HOST_RTOS_H
+#define HOST_RTOS_H
+
+// Tasks are detached threads; core and priority are accepted and ignored,
+// so tests see real concurrency but none of the ESP32 scheduling. Only the
+// calls the firmware makes are here, with the same return conventions.
+
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+typedef void (*TaskFunction_t)(void*);
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define tskIDLE_PRIORITY 0
+
+struct HostTask {
+    std::mutex lock;
+    std::condition_variable wake;
+    uint32_t notifications = 0;
+    bool deleted = false;
+};
+typedef HostTask* TaskHandle_t;
+
+namespace hostrtos {
+
+// Thrown inside a task to unwind it when it is deleted
+struct TaskDeleted {};
+
+inline thread_local std::shared_ptr<HostTask> current;
+
+// Keeps every task's state alive until exit, as the kernel would its TCB
+inline std::mutex registryLock;
+inline std::vector<std::shared_ptr<HostTask>> registry;
+
+template <typename Predicate>
+bool waitFor(std::condition_variable& cv, std::unique_lock<std::mutex>& held,
+             TickType_t ticks, Predicate ready) {
+    if (ticks == portMAX_DELAY) {
+        cv.wait(held, ready);
+        return true;
+    }
+    return cv.wait_for(held, std::chrono::milliseconds(ticks), ready);
+}
+
+}  // namespace hostrtos
+
+inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t entry, const char*, uint32_t,
+                                          void* param, UBaseType_t, TaskHandle_t* handle,
+                                          BaseType_t) {
+    auto task = std::make_shared<HostTask>();
+    {
+        std::lock_guard<std::mutex> held(hostrtos::registryLock);
+        hostrtos::registry.push_back(task);
+    }
+    if (handle) *handle = task.get();
+
+    std::thread([task, entry, param]() {
+        hostrtos::current = task;
+        try {
+            entry(param);
+        } catch (const hostrtos::TaskDeleted&) {
+        }
+    }).detach();
+    return pdPASS;
+}
+
+// Threads the test started itself get a task on first use, as loopTask
+// would on the device
+inline TaskHandle_t xTaskGetCurrentTaskHandle() {
+    if (!hostrtos::current) {
+        hostrtos::current = std::make_shared<HostTask>();
+        std::lock_guard<std::mutex> held(hostrtos::registryLock);
+        hostrtos::registry.push_back(hostrtos::current);
+    }
+    return hostrtos::current.get();
+}
+
+inline void vTaskDelete(TaskHandle_t task) {
+    if (!task || task == hostrtos::current.get()) throw hostrtos::TaskDeleted();
+    std::lock_guard<std::mutex> held(task->lock);
+    task->deleted = true;
+    task->wake.notify_all();
+}
+
+inline void xTaskNotifyGive(TaskHandle_t task) {
+    std::lock_guard<std::mutex> held(task->lock);
+    task->notifications++;
+    task->wake.notify_all();
+}
+
+// A deleted task never returns from here
+inline uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks) {
+    HostTask& task = *xTaskGetCurrentTaskHandle();
+    std::unique_lock<std::mutex> held(task.lock);
+    hostrtos::waitFor(task.wake, held, ticks,
+                      [&task] { return task.notifications > 0 || task.deleted; });
+    if (task.deleted) throw hostrtos::TaskDeleted();
+
+    uint32_t value = task.notifications;
+    if (value) task.notifications = clearOnExit ? 0 : value - 1;
+    return value;
+}
+
+inline void vTaskDelay(TickType_t ticks) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
+
+inline void taskYIELD() {
+    std::this_thread::yield();
+}
+
+inline BaseType_t xPortGetCoreID() {
+    return 0;
+}
+
+inline void disableCore0WDT() {}
+
+// Fixed-size item FIFO
+struct HostQueue {
+    std::mutex lock;
+    std::condition_variable changed;
+    std::deque<std::vector<uint8_t>> items;
+    UBaseType_t capacity;
+    UBaseType_t itemSize;
+};
+typedef HostQueue* QueueHandle_t;
+
+inline QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+    QueueHandle_t queue = new HostQueue();
+    queue->capacity = length;
+    queue->itemSize = itemSize;
+    return queue;
+}
+
+inline BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticks) {
+    std::unique_lock<std::mutex> held(queue->lock);
+    if (!hostrtos::waitFor(queue->changed, held, ticks,
+                           [queue] { return queue->items.size() < queue->capacity; })) {
+        return pdFALSE;
+    }
+    const uint8_t* bytes = static_cast<const uint8_t*>(item);
+    queue->items.emplace_back(bytes, bytes + queue->itemSize);
+    queue->changed.notify_all();
+    return pdTRUE;
+}
+
+inline BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t ticks) {
+    std::unique_lock<std::mutex> held(queue->lock);
+    if (!hostrtos::waitFor(queue->changed, held, ticks,
+                           [queue] { return !queue->items.empty(); })) {
+        return pdFALSE;
+    }
+    memcpy(item, queue->items.front().data(), queue->itemSize);
+    queue->items.pop_front();
+    queue->changed.notify_all();
+    return pdTRUE;
+}
+
+inline BaseType_t xQueueReset(QueueHandle_t queue) {
+    std::lock_guard<std::mutex> held(queue->lock);
+    queue->items.clear();
+    queue->changed.notify_all();
+    return pdPASS;
+}
+
+inline UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+    std::lock_guard<std::mutex> held(queue->lock);
+    return queue->items.size();
+}
+
+// Mutexes only; no priority inheritance to model on the host
+typedef std::timed_mutex* SemaphoreHandle_t;
+
+inline SemaphoreHandle_t xSemaphoreCreateMutex() {
+    return new std::timed_mutex();
+}
+
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t mutex, TickType_t ticks) {
+    if (ticks == portMAX_DELAY) {
+        mutex->lock();
+        return pdTRUE;
+    }
+    return mutex->try_lock_for(std::chrono::milliseconds(ticks)) ? pdTRUE : pdFALSE;
+}
+
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t mutex) {
+    mutex->unlock();
+    return pdTRUE;
+}
+
+#endif
@@ -0,0 +1,223 @@
+// ============================================================================
+// driver/adc.h - Host stand-in for the ESP-IDF continuous ADC driver
+// ============================================================================
+#ifndef HOST_DRIVER_ADC_H
+#define HOST_DRIVER_ADC_H
+
+// A thread plays the DMA: every conv_num_each_intr bytes' worth of real
+// time it appends one block of conversions to a bounded pool, or, when the
+// pool is full, drops the block and flags the overflow for the next read,
+// as the driver does. HostAdc::source supplies the readings; by default
+// each slot ramps by one count per frame, so a gap shows as a jump.
+
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+typedef int esp_err_t;
+
+#define ESP_OK 0
+#define ESP_FAIL -1
+#define ESP_ERR_INVALID_ARG 0x102
+#define ESP_ERR_INVALID_STATE 0x103
+#define ESP_ERR_TIMEOUT 0x107
+
+#define SOC_ADC_DIGI_MAX_BITWIDTH 12
+
+typedef enum {
+    ADC_ATTEN_DB_0 = 0,
+    ADC_ATTEN_DB_2_5 = 1,
+    ADC_ATTEN_DB_6 = 2,
+    ADC_ATTEN_DB_11 = 3,
+} adc_atten_t;
+
+typedef enum {
+    ADC_CONV_SINGLE_UNIT_1 = 1,
+    ADC_CONV_SINGLE_UNIT_2 = 2,
+    ADC_CONV_BOTH_UNIT = 3,
+    ADC_CONV_ALTER_UNIT = 7,
+} adc_digi_convert_mode_t;
+
+typedef enum {
+    ADC_DIGI_OUTPUT_FORMAT_TYPE1,
+    ADC_DIGI_OUTPUT_FORMAT_TYPE2,
+} adc_digi_output_format_t;
+
+typedef struct {
+    uint8_t atten;
+    uint8_t channel;
+    uint8_t unit;
+    uint8_t bit_width;
+} adc_digi_pattern_config_t;
+
+typedef struct {
+    bool conv_limit_en;
+    uint32_t conv_limit_num;
+    uint32_t pattern_num;
+    adc_digi_pattern_config_t* adc_pattern;
+    uint32_t sample_freq_hz;
+    adc_digi_convert_mode_t conv_mode;
+    adc_digi_output_format_t format;
+} adc_digi_configuration_t;
+
+typedef struct {
+    uint32_t max_store_buf_size;
+    uint32_t conv_num_each_intr;
+    uint32_t adc1_chan_mask;
+    uint32_t adc2_chan_mask;
+} adc_digi_init_config_t;
+
+// ESP32-S3 layout
+typedef struct {
+    union {
+        struct {
+            uint32_t data : 13;
+            uint32_t reserved13 : 1;
+            uint32_t channel : 4;
+            uint32_t unit : 1;
+            uint32_t reserved18_31 : 13;
+        } type2;
+        uint32_t val;
+    };
+} adc_digi_output_data_t;
+
+namespace HostAdc {
+
+inline uint16_t ramp(int slot, uint64_t frame) {
+    return (uint16_t)((frame + slot * 2048) & 0xFFF);
+}
+
+// Reading of pattern slot 'slot' in frame 'frame' since the start
+inline uint16_t (*source)(int slot, uint64_t frame) = ramp;
+
+struct Driver {
+    std::mutex lock;
+    std::condition_variable ready;
+    std::deque<uint32_t> pool;
+    size_t capacity = 0;                // Conversions
+    size_t blockConversions = 0;
+    adc_digi_pattern_config_t pattern[8];
+    uint32_t patternCount = 0;
+    uint32_t rate = 0;
+    bool initialized = false;
+    bool overflow = false;
+    uint64_t dropped = 0;               // Conversions that never reached the pool
+    std::atomic<bool> running{false};
+    std::thread dma;
+};
+
+inline Driver& driver() {
+    static Driver instance;
+    return instance;
+}
+
+inline void dmaLoop() {
+    Driver& d = driver();
+    auto period = std::chrono::nanoseconds(1000000000ULL * d.blockConversions / d.rate);
+    auto next = std::chrono::steady_clock::now();
+    uint64_t conversion = 0;
+
+    while (d.running) {
+        next += period;
+        std::this_thread::sleep_until(next);
+
+        std::lock_guard<std::mutex> guard(d.lock);
+        bool fits = d.pool.size() + d.blockConversions <= d.capacity;
+        for (size_t i = 0; i < d.blockConversions; i++, conversion++) {
+            if (!fits) continue;
+            int slot = conversion % d.patternCount;
+            adc_digi_output_data_t out;
+            out.val = 0;
+            out.type2.data = source(slot, conversion / d.patternCount);
+            out.type2.channel = d.pattern[slot].channel;
+            out.type2.unit = d.pattern[slot].unit;
+            d.pool.push_back(out.val);
+        }
+        if (!fits) {
+            d.overflow = true;
+            d.dropped += d.blockConversions;
+        }
+        d.ready.notify_all();
+    }
+}
+
+}  // namespace HostAdc
+
+inline esp_err_t adc_digi_initialize(const adc_digi_init_config_t* config) {
+    HostAdc::Driver& d = HostAdc::driver();
+    if (d.initialized || config->conv_num_each_intr > config->max_store_buf_size) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    d.capacity = config->max_store_buf_size / sizeof(adc_digi_output_data_t);
+    d.blockConversions = config->conv_num_each_intr / sizeof(adc_digi_output_data_t);
+    d.pool.clear();
+    d.overflow = false;
+    d.dropped = 0;
+    d.initialized = true;
+    return ESP_OK;
+}
+
+inline esp_err_t adc_digi_controller_configure(const adc_digi_configuration_t* config) {
+    HostAdc::Driver& d = HostAdc::driver();
+    if (!d.initialized || config->pattern_num == 0 || config->pattern_num > 8) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (uint32_t i = 0; i < config->pattern_num; i++) d.pattern[i] = config->adc_pattern[i];
+    d.patternCount = config->pattern_num;
+    d.rate = config->sample_freq_hz;
+    return ESP_OK;
+}
+
+inline esp_err_t adc_digi_start() {
+    HostAdc::Driver& d = HostAdc::driver();
+    if (!d.initialized || d.rate == 0 || d.running) return ESP_ERR_INVALID_STATE;
+    d.running = true;
+    d.dma = std::thread(HostAdc::dmaLoop);
+    return ESP_OK;
+}
+
+inline esp_err_t adc_digi_stop() {
+    HostAdc::Driver& d = HostAdc::driver();
+    if (!d.running) return ESP_ERR_INVALID_STATE;
+    d.running = false;
+    d.dma.join();
+    return ESP_OK;
+}
+
+inline esp_err_t adc_digi_deinitialize() {
+    HostAdc::Driver& d = HostAdc::driver();
+    if (d.running) adc_digi_stop();
+    d.initialized = false;
+    d.pool.clear();
+    return ESP_OK;
+}
+
+inline esp_err_t adc_digi_read_bytes(uint8_t* buf, uint32_t length_max, uint32_t* out_length,
+                                     uint32_t timeout_ms) {
+    HostAdc::Driver& d = HostAdc::driver();
+    std::unique_lock<std::mutex> guard(d.lock);
+
+    *out_length = 0;
+    if (!d.ready.wait_for(guard, std::chrono::milliseconds(timeout_ms),
+                          [&d] { return !d.pool.empty(); })) {
+        return ESP_ERR_TIMEOUT;
+    }
+    esp_err_t result = d.overflow ? ESP_ERR_INVALID_STATE : ESP_OK;
+    d.overflow = false;
+
+    size_t count = std::min<size_t>(length_max / sizeof(uint32_t), d.pool.size());
+    for (size_t i = 0; i < count; i++) {
+        memcpy(buf + i * sizeof(uint32_t), &d.pool.front(), sizeof(uint32_t));
+        d.pool.pop_front();
+    }
+    *out_length = count * sizeof(uint32_t);
+    return result;
+}
+
+#endif
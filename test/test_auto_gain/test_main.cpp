@@ -0,0 +1,90 @@
+// ============================================================================
+// test_auto_gain - Fixed wake-word gain against the adaptive AGC
+// ============================================================================
+#include <Arduino.h>
+#include <unity.h>
+#include "AutoGain.h"
+
+// Blocks of a 500 Hz tone on a 12-bit ADC bias, the way MIC_readFrames
+// feeds the gain: both channels per frame, endBlock() per chunk
+
+static const int BIAS = 1900;
+static const int BLOCK = 1600;
+
+static int16_t out[BLOCK];
+
+static int32_t runBlock(AutoGain& gain, int amplitude) {
+    int32_t peak = 0;
+    for (int i = 0; i < BLOCK; i++) {
+        int raw = BIAS + (int)lround(amplitude * sin(2 * PI * 500 * i / 16000.0));
+        out[i] = gain.process(0, raw);
+        gain.process(1, raw);
+        peak = max(peak, (int32_t)abs(out[i]));
+    }
+    gain.endBlock();
+    return peak;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_fixed_gain_is_the_trained_x50() {
+    AutoGain wake(50 << 8, false);
+
+    // Quiet input: exactly x50 of the swing, block after block
+    for (int b = 0; b < 50; b++) {
+        int32_t peak = runBlock(wake, 20);
+        TEST_ASSERT_INT_WITHIN(50, 1000, peak);
+    }
+    TEST_ASSERT_EQUAL_INT32(50 << 8, wake.getStats().gainQ8);
+}
+
+void test_fixed_gain_saturates_instead_of_backing_off() {
+    AutoGain wake(50 << 8, false);
+
+    // 1000 counts x50 clips, as the original (raw - 2048) * 50 did
+    for (int b = 0; b < 10; b++) runBlock(wake, 1000);
+    const AutoGain::Stats& stats = wake.getStats();
+    TEST_ASSERT_EQUAL_INT32(50 << 8, stats.gainQ8);
+    TEST_ASSERT_GREATER_THAN(0, stats.clipped);
+    TEST_ASSERT_INT_WITHIN(500, 50000, stats.peak);
+
+    // And comes straight back for the next quiet block, give or take the
+    // bias ripple the loud tone left behind
+    TEST_ASSERT_INT_WITHIN(100, 1000, runBlock(wake, 20));
+}
+
+void test_adaptive_gain_attacks_and_releases() {
+    AutoGain agc;
+
+    // Loud block: the next one is already at the target
+    runBlock(agc, 1000);
+    int32_t peak = runBlock(agc, 1000);
+    TEST_ASSERT_INT_WITHIN(AutoGain::TARGET_PEAK / 20, AutoGain::TARGET_PEAK, peak);
+
+    // Quiet again: the gain creeps back up without overshooting
+    int32_t loudGain = agc.getStats().gainQ8;
+    for (int b = 0; b < 100; b++) {
+        TEST_ASSERT_LESS_OR_EQUAL(AutoGain::TARGET_PEAK, runBlock(agc, 20));
+    }
+    TEST_ASSERT_GREATER_THAN(loudGain, agc.getStats().gainQ8);
+}
+
+void test_bias_is_removed() {
+    AutoGain wake(50 << 8, false);
+    for (int b = 0; b < 20; b++) runBlock(wake, 20);
+
+    int64_t sum = 0;
+    for (int i = 0; i < BLOCK; i++) sum += out[i];
+    TEST_ASSERT_INT_WITHIN(20, 0, (int32_t)(sum / BLOCK));
+    TEST_ASSERT_INT_WITHIN(1, BIAS, wake.getStats().dc[0]);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_fixed_gain_is_the_trained_x50);
+    RUN_TEST(test_fixed_gain_saturates_instead_of_backing_off);
+    RUN_TEST(test_adaptive_gain_attacks_and_releases);
+    RUN_TEST(test_bias_is_removed);
+    return UNITY_END();
+}
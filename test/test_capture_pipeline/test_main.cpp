@@ -0,0 +1,216 @@
+// ============================================================================
+// test_capture_pipeline - DMA capture under the wake pipeline's work pattern
+// ============================================================================
+#include <Arduino.h>
+#include <unity.h>
+#include "AdcStream.h"
+#include "AudioRecorder.h"
+#include "WakePipeline.h"
+
+// The wake pipeline itself, fed by a stand-in source: each call reads one
+// capture chunk and, every WAKE_HOP frames, stalls for the feature
+// extraction. The test thread plays loop(), polling and stalling for the
+// inference. The host ADC driver ramps every channel by one count per
+// frame in real time, so a lost frame shows as a jump.
+
+static const int POOL_FRAMES = WAKE_HOP;
+static const int HOP_FRAMES = 40;           // MFCC rows per hop, as the detector reports them
+
+struct Run {
+    int hops;
+    int featureMs;
+    int inferenceMs;
+
+    // Results
+    uint32_t frames;
+    uint32_t gaps;              // Places where the ramp jumped
+    uint32_t unpaired;          // Frames whose mics disagree
+    uint32_t maxReadMicros;
+    uint32_t scored;
+    uint32_t badNewFrames;      // Windows whose row count ignores a drop
+    uint32_t lastSequence;
+
+    // Source side
+    int hop;
+    int chunkFrames;
+    int last;
+    std::atomic<bool> done;
+};
+
+static AdcStream stream;
+static WakePipeline pipeline;
+static Run* running = nullptr;              // Source state of the run in progress
+
+static void startStream(int poolFrames) {
+    const int pins[] = {micPin1, micPin2};
+    TEST_ASSERT_TRUE(stream.begin(pins, 2, SAMPLE_RATE, poolFrames));
+}
+
+static void checkFrames(const uint16_t* raw, int count, int& last, Run& run) {
+    for (int i = 0; i < count; i++) {
+        int mic1 = raw[2 * i];
+        int mic2 = raw[2 * i + 1];
+        if (mic2 != ((mic1 + 2048) & 0xFFF)) run.unpaired++;
+        if (last >= 0 && mic1 != ((last + 1) & 0xFFF)) run.gaps++;
+        last = mic1;
+    }
+    run.frames += count;
+}
+
+static bool captureWindow(WakePipeline::Window& window, void* context) {
+    Run& run = *running;
+    if (run.hop >= run.hops) {
+        run.done = true;
+        vTaskDelay(1);
+        return false;
+    }
+
+    uint16_t raw[2 * CAPTURE_CHUNK];
+    uint32_t start = micros();
+    stream.read(raw, CAPTURE_CHUNK);            // Stalls are counted
+    run.maxReadMicros = max(run.maxReadMicros, micros() - start);
+    checkFrames(raw, CAPTURE_CHUNK, run.last, run);
+
+    run.chunkFrames += CAPTURE_CHUNK;
+    if (run.chunkFrames < WAKE_HOP) return false;
+    run.chunkFrames = 0;
+
+    // extractFeatures() and the beam render
+    start = micros();
+    delay(run.featureMs);
+    window.features[0][0] = run.hop++;
+    window.newFrames = HOP_FRAMES;
+    window.spectraStart = 0;
+    window.featureMicros = micros() - start;
+    return true;
+}
+
+static void consume(const WakePipeline::Window* window, Run& run) {
+    // A window after a gap in the sequence must rescore every row
+    bool afterGap = run.scored == 0 || window->sequence != run.lastSequence + 1;
+    if (window->newFrames != (afterGap ? N_FRAMES : HOP_FRAMES)) run.badNewFrames++;
+    run.lastSequence = window->sequence;
+
+    // scoreFeatures() and the trigger logic
+    delay(run.inferenceMs);
+    run.scored++;
+}
+
+static void runPipeline(Run& run) {
+    run.last = -1;
+    run.done = false;
+    running = &run;
+    pipeline.resetStats();
+    pipeline.start();
+
+    for (;;) {
+        const WakePipeline::Window* window = pipeline.poll();
+        if (window) {
+            consume(window, run);
+        } else if (run.done) {
+            break;
+        } else {
+            delay(1);
+        }
+    }
+    pipeline.stop();
+
+    // Anything queued after the last poll was produced but never scored
+    while (const WakePipeline::Window* window = pipeline.poll()) consume(window, run);
+}
+
+static void report(const char* label, const Run& run) {
+    char line[200];
+    snprintf(line, sizeof(line),
+             "%s: %lu frames, %lu gaps, %lu overruns, %lu windows (%lu dropped, %lu scored), read max %lu us",
+             label, (unsigned long)run.frames, (unsigned long)run.gaps,
+             (unsigned long)stream.getOverruns(), (unsigned long)pipeline.getStats().produced,
+             (unsigned long)pipeline.getStats().dropped, (unsigned long)run.scored,
+             (unsigned long)run.maxReadMicros);
+    TEST_MESSAGE(line);
+}
+
+void setUp() {}
+
+void tearDown() {
+    stream.end();
+}
+
+void test_features_inside_the_pool_leave_no_gap() {
+    // Features take 60% of a hop and inference 80%: the old capture lost
+    // the features' share of every hop
+    startStream(POOL_FRAMES);
+    Run run = {8, 150, 200};
+    runPipeline(run);
+    report("pool 250 ms", run);
+
+    const WakePipeline::Stats& stats = pipeline.getStats();
+    TEST_ASSERT_EQUAL_UINT32(8 * WAKE_HOP, run.frames);
+    TEST_ASSERT_EQUAL_UINT32(0, run.gaps);
+    TEST_ASSERT_EQUAL_UINT32(0, run.unpaired);
+    TEST_ASSERT_EQUAL_UINT32(0, stream.getOverruns());
+    TEST_ASSERT_EQUAL_UINT32(0, stream.getStalls());
+    TEST_ASSERT_EQUAL_UINT32(8, stats.produced);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.dropped);
+    TEST_ASSERT_EQUAL_UINT32(8, run.scored);
+    TEST_ASSERT_EQUAL_UINT32(0, run.badNewFrames);
+}
+
+void test_slow_scoring_drops_windows_and_resyncs() {
+    // Inference takes two and a half hops: the queue fills, the capture
+    // drops windows rather than waiting, and the window after each drop
+    // asks for a full pass
+    startStream(POOL_FRAMES);
+    Run run = {10, 20, 625};
+    runPipeline(run);
+    report("slow scoring", run);
+
+    const WakePipeline::Stats& stats = pipeline.getStats();
+    TEST_ASSERT_EQUAL_UINT32(0, run.gaps);
+    TEST_ASSERT_EQUAL_UINT32(0, stream.getOverruns());
+    TEST_ASSERT_GREATER_THAN(0, stats.dropped);
+    TEST_ASSERT_EQUAL_UINT32(10, stats.produced);
+    TEST_ASSERT_EQUAL_UINT32(stats.produced, run.scored + stats.dropped);
+    TEST_ASSERT_EQUAL_UINT32(0, run.badNewFrames);
+}
+
+void test_features_past_the_pool_are_reported() {
+    // A 64 ms pool under 150 ms of features: frames are lost, and every
+    // loss is flagged
+    startStream(1024);
+    Run run = {4, 150, 50};
+    runPipeline(run);
+    report("pool 64 ms", run);
+
+    TEST_ASSERT_GREATER_THAN(0, run.gaps);
+    TEST_ASSERT_GREATER_THAN(0, stream.getOverruns());
+    TEST_ASSERT_EQUAL_UINT32(0, run.unpaired);
+}
+
+void test_drain_starts_the_capture_now() {
+    // Nobody reads for longer than the pool: the overflow is not an overrun
+    // once drained, and the stream after it is whole
+    startStream(POOL_FRAMES);
+    delay(400);
+    stream.drain();
+
+    Run run = {2, 0, 0};
+    runPipeline(run);
+    report("after drain", run);
+
+    TEST_ASSERT_EQUAL_UINT32(0, stream.getOverruns());
+    TEST_ASSERT_EQUAL_UINT32(0, run.gaps);
+    TEST_ASSERT_EQUAL_UINT32(0, run.unpaired);
+    TEST_ASSERT_EQUAL_UINT32(0, run.badNewFrames);
+}
+
+int main(int argc, char** argv) {
+    pipeline.begin(captureWindow, nullptr);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_features_inside_the_pool_leave_no_gap);
+    RUN_TEST(test_slow_scoring_drops_windows_and_resyncs);
+    RUN_TEST(test_features_past_the_pool_are_reported);
+    RUN_TEST(test_drain_starts_the_capture_now);
+    return UNITY_END();
+}
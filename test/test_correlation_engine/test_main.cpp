@@ -0,0 +1,220 @@
+// ============================================================================
+// test_correlation_engine - Prefix-moment windows against a naive reference
+// ============================================================================
+#include <Arduino.h>
+#include <unity.h>
+#include "CorrelationEngine.h"
+
+// Every query is checked against sums taken directly over the window and
+// a two-pass double-precision Pearson coefficient. Moments must match
+// exactly; the Q8 correlation may differ from floor(256 r) by one step,
+// the rounding of its integer square roots.
+
+static const int LENGTH = 16000;
+static const int WINDOW = 800;
+static const int STRIDE = 400;
+
+static int16_t x[LENGTH];
+static int16_t y[LENGTH];
+static int16_t frames[2 * LENGTH];     // x/y interleaved
+static uint32_t rng = 1;
+
+static uint32_t next() {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static int16_t noise(int amplitude) {
+    return (int16_t)((int32_t)(next() % (2 * amplitude + 1)) - amplitude);
+}
+
+static CorrelationEngine::Moments naiveMoments(const int16_t* a, const int16_t* b, size_t start,
+                                               size_t count, int stride = 1) {
+    CorrelationEngine::Moments m = {0, 0, 0, 0, 0};
+    for (size_t i = start; i < start + count; i++) {
+        int64_t p = a[i * stride];
+        int64_t q = b[i * stride];
+        m.sx += p;
+        m.sy += q;
+        m.sxx += p * p;
+        m.syy += q * q;
+        m.sxy += p * q;
+    }
+    return m;
+}
+
+// floor(256 r), clamped to [0, 256] like the engine
+static int naiveQ8(const int16_t* a, const int16_t* b, size_t start, size_t count, int stride = 1) {
+    double meanA = 0, meanB = 0;
+    for (size_t i = start; i < start + count; i++) {
+        meanA += a[i * stride];
+        meanB += b[i * stride];
+    }
+    meanA /= count;
+    meanB /= count;
+
+    double saa = 0, sbb = 0, sab = 0;
+    for (size_t i = start; i < start + count; i++) {
+        double p = a[i * stride] - meanA;
+        double q = b[i * stride] - meanB;
+        saa += p * p;
+        sbb += q * q;
+        sab += p * q;
+    }
+    if (saa <= 0 || sbb <= 0) return 0;
+
+    int q8 = (int)floor(256.0 * sab / sqrt(saa * sbb));
+    return q8 < 0 ? 0 : (q8 > 256 ? 256 : q8);
+}
+
+static void assertWindow(const CorrelationEngine& engine, const int16_t* a, const int16_t* b,
+                         size_t start, size_t count, int stride = 1) {
+    CorrelationEngine::Moments got = engine.moments(start, count);
+    CorrelationEngine::Moments want = naiveMoments(a, b, start, count, stride);
+    TEST_ASSERT_EQUAL_INT64(want.sx, got.sx);
+    TEST_ASSERT_EQUAL_INT64(want.sy, got.sy);
+    TEST_ASSERT_EQUAL_INT64(want.sxx, got.sxx);
+    TEST_ASSERT_EQUAL_INT64(want.syy, got.syy);
+    TEST_ASSERT_EQUAL_INT64(want.sxy, got.sxy);
+
+    TEST_ASSERT_INT_WITHIN(1, naiveQ8(a, b, start, count, stride),
+                           engine.correlationQ8(start, count));
+}
+
+// Mic pair: a shared source plus independent noise, changing mix over time
+// so windows span the whole correlation range
+static void fillPair() {
+    rng = 12345;
+    int32_t source = 0;
+    for (int i = 0; i < LENGTH; i++) {
+        source = (source * 7 + noise(8000)) / 8;
+        int shared = (i / 1000) % 4;     // 0: uncorrelated ... 3: mostly shared
+        x[i] = (int16_t)(source * shared / 3 + noise(2000));
+        y[i] = (int16_t)(source * shared / 3 + noise(2000) + 300);
+        frames[2 * i] = x[i];
+        frames[2 * i + 1] = y[i];
+    }
+}
+
+void setUp() {
+    fillPair();
+}
+
+void tearDown() {}
+
+void test_aligned_windows_match() {
+    CorrelationEngine engine;
+    engine.build(x, y, LENGTH, STRIDE);
+    for (size_t start = 0; start + WINDOW <= LENGTH; start += STRIDE) {
+        assertWindow(engine, x, y, start, WINDOW);
+    }
+}
+
+void test_unaligned_windows_match() {
+    CorrelationEngine engine;
+    engine.build(x, y, LENGTH, STRIDE);
+    rng = 99;
+    for (int t = 0; t < 500; t++) {
+        size_t start = next() % LENGTH;
+        size_t count = 1 + next() % (LENGTH - start);
+        assertWindow(engine, x, y, start, count);
+    }
+}
+
+void test_whole_capture_and_tail_match() {
+    CorrelationEngine engine;
+    engine.build(x, y, LENGTH - 37, STRIDE);
+    assertWindow(engine, x, y, 0, LENGTH - 37);
+    assertWindow(engine, x, y, LENGTH - 37 - 500, 500);
+
+    // Windows past the data are clipped to it
+    CorrelationEngine::Moments clipped = engine.moments(LENGTH - 137, 1000);
+    CorrelationEngine::Moments want = naiveMoments(x, y, LENGTH - 137, 100);
+    TEST_ASSERT_EQUAL_INT64(want.sxy, clipped.sxy);
+}
+
+void test_streaming_interleaved_matches_at_every_chunk() {
+    CorrelationEngine engine;
+    engine.begin(frames, frames + 1, LENGTH, STRIDE, 2);
+
+    rng = 7;
+    for (size_t length = 100; length <= (size_t)LENGTH; length += 100) {
+        engine.extend(length);
+        TEST_ASSERT_EQUAL_UINT32(length, engine.getLength());
+        assertWindow(engine, frames, frames + 1, 0, length, 2);
+
+        size_t start = next() % length;
+        assertWindow(engine, frames, frames + 1, start, 1 + next() % (length - start), 2);
+    }
+}
+
+void test_coarsened_table_still_matches() {
+    // 48000 samples over 128 blocks: blocks grow past the 100-sample alignment
+    static int16_t longX[48000];
+    static int16_t longY[48000];
+    for (int i = 0; i < 48000; i++) {
+        longX[i] = x[i % LENGTH];
+        longY[i] = y[(i * 7) % LENGTH];
+    }
+
+    CorrelationEngine engine;
+    engine.build(longX, longY, 48000, 100);
+    rng = 3;
+    for (int t = 0; t < 200; t++) {
+        size_t start = next() % 48000;
+        size_t count = 1 + next() % (48000 - start);
+        assertWindow(engine, longX, longY, start, count);
+    }
+}
+
+void test_degenerate_signals() {
+    static int16_t flat[WINDOW];
+    static int16_t inverted[WINDOW];
+    for (int i = 0; i < WINDOW; i++) {
+        flat[i] = 1234;
+        inverted[i] = -x[i];
+    }
+
+    CorrelationEngine engine;
+    engine.build(x, x, WINDOW, STRIDE);
+    TEST_ASSERT_EQUAL_INT(256, engine.correlationQ8(0, WINDOW));
+
+    engine.build(x, inverted, WINDOW, STRIDE);
+    TEST_ASSERT_EQUAL_INT(0, engine.correlationQ8(0, WINDOW));
+
+    engine.build(x, flat, WINDOW, STRIDE);
+    TEST_ASSERT_EQUAL_INT(0, engine.correlationQ8(0, WINDOW));
+    TEST_ASSERT_EQUAL_INT(0, engine.correlationQ8(0, 0));
+}
+
+void test_full_scale_does_not_overflow() {
+    // The documented limit: ~64k full-scale samples
+    static const int N = 65535;
+    static int16_t a[N];
+    static int16_t b[N];
+    rng = 5;
+    for (int i = 0; i < N; i++) {
+        a[i] = (next() & 1) ? 32767 : -32768;
+        b[i] = (next() & 3) ? a[i] : (int16_t)-a[i];
+    }
+
+    CorrelationEngine engine;
+    engine.build(a, b, N, 1024);
+    assertWindow(engine, a, b, 0, N);
+    engine.build(a, a, N, 1024);
+    TEST_ASSERT_EQUAL_INT(256, engine.correlationQ8(0, N));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_aligned_windows_match);
+    RUN_TEST(test_unaligned_windows_match);
+    RUN_TEST(test_whole_capture_and_tail_match);
+    RUN_TEST(test_streaming_interleaved_matches_at_every_chunk);
+    RUN_TEST(test_coarsened_table_still_matches);
+    RUN_TEST(test_degenerate_signals);
+    RUN_TEST(test_full_scale_does_not_overflow);
+    return UNITY_END();
+}
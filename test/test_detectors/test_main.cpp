@@ -0,0 +1,354 @@
+// ============================================================================
+// test_detectors - DTMF, wake-word and laser detectors on synthetic audio
+// ============================================================================
+#include <Arduino.h>
+#include <unity.h>
+#include "AudioRecorder.h"
+#include "DTMFDetector.h"
+#include "GoertzelBank.h"
+#include "LaserAttackDetector.h"
+#include "SignalSynth.h"
+#include "VoiceDetector.h"
+
+// Detectors are fed exactly as the capture engine feeds them: interleaved
+// 16 kHz mic pairs, CAPTURE_CHUNK frames at a time. The corpus is seeded,
+// so every run sees the same audio. Throughput is reported per case
+// (16000 samples/s is real time on the device; the host is only a guide).
+
+static const int TRIALS = 4;
+static const int BABBLE_LENGTH = 4000;
+static const float WAKE_THRESHOLD = 0.90f;
+
+static const char* const DTMF_SEQUENCES[] = {"12345678", "90*#ABCD"};
+static const int DTMF_SEQUENCE_COUNT = 2;
+
+//                                              level  twist  offset  snr  tone gap
+static const SignalSynth::DtmfSpec NOMINAL = {-20, 0, 0, 20, 50, 50};
+
+static SignalSynth synth;
+static AudioBlock block;
+static Resampler pitch;
+static DTMFDetector dtmf;
+static LaserAttackDetector laser;
+static VoiceDetector* voice = nullptr;
+
+// Low-passed noise standing in for a talker
+static int16_t babble[BABBLE_LENGTH];
+static SampleView speech(babble, BABBLE_LENGTH);
+
+struct DtmfOutcome {
+    int expected;
+    int detected;
+    int falseKeys;
+};
+
+static void reportRate(const char* label, uint32_t samples, uint32_t elapsed) {
+    char line[96];
+    float perSecond = elapsed ? samples * 1e6f / elapsed : 0.0f;
+    snprintf(line, sizeof(line), "%s: %.0f samples/s (%.1fx real time)",
+             label, perSecond, perSecond / SAMPLE_RATE);
+    TEST_MESSAGE(line);
+}
+
+// Empty capture block, ready to be written in place
+static int16_t* beginFrames() {
+    block.clear();
+    int16_t* frames = block.frameAt(0);
+    memset(frames, 0, BUFFER_SIZE * 2 * sizeof(int16_t));
+    return frames;
+}
+
+static DtmfOutcome runDtmf(const SignalSynth::DtmfSpec& spec, bool expectKeys, bool withSpeech) {
+    DtmfOutcome outcome = {0, 0, 0};
+    uint32_t samples = 0, elapsed = 0;
+
+    for (int s = 0; s < DTMF_SEQUENCE_COUNT; s++) {
+        const char* sequence = expectKeys ? DTMF_SEQUENCES[s] : "        ";
+        int16_t* frames = beginFrames();
+        int n = synth.dtmf(sequence, spec, frames, BUFFER_SIZE);
+        if (withSpeech) synth.mix(frames, n, speech, 0.0f, 2, 0.9f);
+
+        dtmf.resetStream();
+        int next = 0;
+        for (int i = 0; i < n; i += CAPTURE_CHUNK) {
+            int count = n - i < CAPTURE_CHUNK ? n - i : CAPTURE_CHUNK;
+            uint32_t start = micros();
+            dtmf.feedCapture(frames + 2 * i, count);
+            elapsed += micros() - start;
+
+            char key = dtmf.takeKey();
+            if (key == '\0') continue;
+            // Keys must arrive in order; anything else is a false detection
+            if (expectKeys && sequence[next] == key) {
+                next++;
+                outcome.detected++;
+            } else {
+                outcome.falseKeys++;
+            }
+        }
+        if (expectKeys) outcome.expected += strlen(sequence);
+        samples += n;
+    }
+
+    reportRate("decode", samples, elapsed);
+    return outcome;
+}
+
+static void assertDecodes(const SignalSynth::DtmfSpec& spec, bool withSpeech = false) {
+    DtmfOutcome outcome = runDtmf(spec, true, withSpeech);
+    TEST_ASSERT_EQUAL_INT(outcome.expected, outcome.detected);
+    TEST_ASSERT_EQUAL_INT(0, outcome.falseKeys);
+}
+
+static void assertSilent(const SignalSynth::DtmfSpec& spec, bool withSpeech = false) {
+    DtmfOutcome outcome = runDtmf(spec, false, withSpeech);
+    TEST_ASSERT_EQUAL_INT(0, outcome.falseKeys);
+}
+
+void setUp() {
+    synth.seed(1);
+}
+
+void tearDown() {
+    dtmf.resetStream();
+}
+
+void test_dtmf_nominal() {
+    assertDecodes(NOMINAL);
+}
+
+void test_dtmf_snr_10db() {
+    SignalSynth::DtmfSpec spec = NOMINAL;
+    spec.snrDb = 10;
+    assertDecodes(spec);
+}
+
+void test_dtmf_twist_plus_4db() {
+    SignalSynth::DtmfSpec spec = NOMINAL;
+    spec.twistDb = 4;
+    assertDecodes(spec);
+}
+
+void test_dtmf_twist_minus_8db() {
+    SignalSynth::DtmfSpec spec = NOMINAL;
+    spec.twistDb = -8;
+    assertDecodes(spec);
+}
+
+void test_dtmf_offset_plus_1_5_percent() {
+    SignalSynth::DtmfSpec spec = NOMINAL;
+    spec.offsetPct = 1.5f;
+    assertDecodes(spec);
+}
+
+void test_dtmf_40ms_tones() {
+    SignalSynth::DtmfSpec spec = NOMINAL;
+    spec.toneMs = 40;
+    spec.gapMs = 40;
+    assertDecodes(spec);
+}
+
+void test_dtmf_with_speech() {
+    assertDecodes(NOMINAL, true);
+}
+
+void test_dtmf_rejects_offset_3_5_percent() {
+    SignalSynth::DtmfSpec spec = NOMINAL;
+    spec.offsetPct = -3.5f;
+    assertSilent(spec);
+}
+
+// The int32 recursion relies on the pre-scaled input; a full-scale square
+// wave at each tone is the worst a block can do to the state
+void test_goertzel_full_scale() {
+    static const float FREQS[GoertzelBank::FILTERS] = {697, 770, 852, 941, 1209, 1336, 1477, 1633};
+    GoertzelBank bank;
+    bank.init(FREQS, DTMF_SAMPLE_RATE);
+
+    for (int f = 0; f < GoertzelBank::FILTERS; f++) {
+        float w = 2.0f * PI * FREQS[f] / DTMF_SAMPLE_RATE;
+        float c = 2.0f * cosf(w);
+        int16_t x[DTMF_BLOCK_SIZE];
+        float a = 0.0f, b = 0.0f;
+        for (int n = 0; n < DTMF_BLOCK_SIZE; n++) {
+            x[n] = cosf(w * n) >= 0.0f ? 32767 : -32768;
+            float s0 = c * a - b + x[n];
+            b = a;
+            a = s0;
+        }
+
+        bank.reset();
+        bank.process(x, DTMF_BLOCK_SIZE);
+        float power[GoertzelBank::FILTERS];
+        bank.magnitudes(power, 1.0f);
+        float expected = a * a + b * b - c * a * b;
+        TEST_ASSERT_FLOAT_WITHIN(0.02f * expected, expected, power[f]);
+    }
+}
+
+void test_dtmf_rejects_noise() {
+    assertSilent(NOMINAL);
+}
+
+void test_dtmf_rejects_speech() {
+    assertSilent(NOMINAL, true);
+}
+
+// Babble may resemble anything, so only noise and tones can count as false
+static void assertNoFalseWakes(bool withTones) {
+    int falseWakes = 0;
+    float worst = 0.0f;
+    uint32_t elapsed = 0;
+
+    for (int t = 0; t < TRIALS; t++) {
+        int16_t* frames = beginFrames();
+        if (withTones) synth.dtmf(DTMF_SEQUENCES[t & 1], NOMINAL, frames, BUFFER_SIZE);
+        synth.addNoise(frames, BUFFER_SIZE, -50);
+        block.commit(BUFFER_SIZE);
+
+        // Mic 1 through the capture's pitch stretch, as MIC_pitchView(1)
+        SampleView view = SampleView::resampled(&pitch, block.data(), block.getLength(),
+                                                BUFFER_SIZE, block.getChannels());
+        uint32_t start = micros();
+        float score = voice->detectWakeWord(view);
+        elapsed += micros() - start;
+
+        if (score > worst) worst = score;
+        if (score > WAKE_THRESHOLD) falseWakes++;
+    }
+
+    char line[64];
+    snprintf(line, sizeof(line), "max score %.3f", worst);
+    TEST_MESSAGE(line);
+    reportRate("inference", TRIALS * BUFFER_SIZE, elapsed);
+    TEST_ASSERT_EQUAL_INT(0, falseWakes);
+}
+
+void test_wake_ignores_noise() {
+    assertNoFalseWakes(false);
+}
+
+void test_wake_ignores_dtmf() {
+    assertNoFalseWakes(true);
+}
+
+// Acoustic: both mics, arriving a few samples apart. Laser: mic 1 only.
+static int countAttacks(bool injected) {
+    int flagged = 0;
+    uint32_t elapsed = 0;
+
+    for (int t = 0; t < TRIALS; t++) {
+        int16_t* frames = beginFrames();
+        int delay = t - TRIALS / 2;
+        if (injected) {
+            synth.mix(frames, BUFFER_SIZE, speech, 0.0f, 0, 0.0f);
+        } else if (delay >= 0) {
+            synth.mix(frames, BUFFER_SIZE, speech, 0.0f, delay, 0.9f);
+        } else {
+            // Sound from the other side: mic 2 leads
+            synth.mix(frames, BUFFER_SIZE, speech, 0.0f, -delay, 0.9f);
+            for (int i = 0; i < BUFFER_SIZE; i++) {
+                int16_t swap = frames[2 * i];
+                frames[2 * i] = frames[2 * i + 1];
+                frames[2 * i + 1] = swap;
+            }
+        }
+        synth.addNoise(frames, BUFFER_SIZE, -50);
+
+        uint32_t start = micros();
+        laser.beginCapture(block);
+        for (int i = 0; i < BUFFER_SIZE; i += CAPTURE_CHUNK) {
+            block.commit(CAPTURE_CHUNK);
+            laser.onSamples(block.getLength());
+        }
+        bool attack = laser.getResult().attackDetected;
+        elapsed += micros() - start;
+
+        if (attack) flagged++;
+    }
+
+    reportRate("analysis", TRIALS * BUFFER_SIZE, elapsed);
+    return flagged;
+}
+
+void test_laser_passes_acoustic() {
+    TEST_ASSERT_EQUAL_INT(0, countAttacks(false));
+}
+
+void test_laser_flags_injected() {
+    TEST_ASSERT_EQUAL_INT(TRIALS, countAttacks(true));
+}
+
+// The wake feature pass stores the mic pair's spectra; a window stays
+// readable by its first frame until newer frames overwrite it
+void test_spectra_follow_window() {
+    int16_t* frames = beginFrames();
+    synth.mix(frames, BUFFER_SIZE, speech, 0.0f, 2, 0.9f);
+    synth.addNoise(frames, BUFFER_SIZE, -50);
+    block.commit(BUFFER_SIZE);
+
+    SampleView mic1 = SampleView::resampled(&pitch, block.data(), block.getLength(),
+                                            BUFFER_SIZE, block.getChannels());
+    SampleView mic2 = SampleView::resampled(&pitch, block.data() + 1, block.getLength(),
+                                            BUFFER_SIZE, block.getChannels());
+    const SpectralFrameStore* spectra = voice->getSpectra();
+    const int hop = N_FRAMES / 2;
+
+    TEST_ASSERT_EQUAL_INT(N_FRAMES, voice->extractFeatures(mic1, -1, &mic1, &mic2));
+    uint32_t scored = voice->getSpectraStart();
+    TEST_ASSERT_TRUE(voice->publishSpectra(scored));
+    TEST_ASSERT_EQUAL_INT(N_FRAMES, spectra->getFrameCount());
+    static SpectralFrameStore::Frame expected[N_FRAMES];
+    for (int f = 0; f < N_FRAMES; f++) expected[f] = spectra->getFrame(f);
+    TEST_ASSERT_TRUE(expected[N_FRAMES / 2].energy1[1] > 0.0f);
+
+    // The pipeline runs on a hop past the window that fired
+    TEST_ASSERT_EQUAL_INT(hop, voice->extractFeatures(mic1, hop * HOP_LENGTH, &mic1, &mic2));
+    TEST_ASSERT_EQUAL_UINT32(scored + hop, voice->getSpectraStart());
+    TEST_ASSERT_TRUE(voice->publishSpectra(scored));
+    TEST_ASSERT_EQUAL_MEMORY(expected, &spectra->getFrame(0), sizeof(expected[0]));
+    TEST_ASSERT_EQUAL_MEMORY(&expected[N_FRAMES - 1], &spectra->getFrame(N_FRAMES - 1),
+                             sizeof(expected[0]));
+
+    voice->extractFeatures(mic1, hop * HOP_LENGTH, &mic1, &mic2);
+    voice->extractFeatures(mic1, hop * HOP_LENGTH, &mic1, &mic2);
+    TEST_ASSERT_FALSE(voice->publishSpectra(scored));
+    TEST_ASSERT_EQUAL_INT(0, spectra->getFrameCount());
+}
+
+int main(int argc, char** argv) {
+    block.allocate(2, BUFFER_SIZE, "test capture");
+    pitch.begin(2, 1, 2);
+    dtmf.init();
+    voice = new VoiceDetector();
+
+    synth.seed(1);
+    float lowpassed = 0.0f;
+    for (int i = 0; i < BABBLE_LENGTH; i++) {
+        lowpassed = 0.9f * lowpassed + 0.1f * synth.gaussian(SignalSynth::amplitude(-6));
+        babble[i] = (int16_t)lowpassed;
+    }
+
+    UNITY_BEGIN();
+    RUN_TEST(test_dtmf_nominal);
+    RUN_TEST(test_dtmf_snr_10db);
+    RUN_TEST(test_dtmf_twist_plus_4db);
+    RUN_TEST(test_dtmf_twist_minus_8db);
+    RUN_TEST(test_dtmf_offset_plus_1_5_percent);
+    RUN_TEST(test_dtmf_40ms_tones);
+    RUN_TEST(test_dtmf_with_speech);
+    RUN_TEST(test_dtmf_rejects_offset_3_5_percent);
+    RUN_TEST(test_goertzel_full_scale);
+    RUN_TEST(test_dtmf_rejects_noise);
+    RUN_TEST(test_dtmf_rejects_speech);
+    RUN_TEST(test_wake_ignores_noise);
+    RUN_TEST(test_wake_ignores_dtmf);
+    RUN_TEST(test_laser_passes_acoustic);
+    RUN_TEST(test_laser_flags_injected);
+    RUN_TEST(test_spectra_follow_window);
+    int failures = UNITY_END();
+
+    delete voice;
+    block.release("test capture");
+    return failures;
+}
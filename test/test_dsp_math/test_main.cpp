@@ -0,0 +1,91 @@
+// ============================================================================
+// test_dsp_math - isqrt64 against a naive reference
+// ============================================================================
+#include <Arduino.h>
+#include <unity.h>
+#include "DspMath.h"
+
+// r is floor(sqrt(v)) exactly when r^2 <= v < (r + 1)^2; 128-bit products
+// keep the check itself from overflowing at the top of the range
+static bool isFloorRoot(uint64_t v, uint32_t r) {
+    unsigned __int128 square = (unsigned __int128)r * r;
+    unsigned __int128 next = (unsigned __int128)(r + 1ULL) * (r + 1ULL);
+    return square <= v && v < next;
+}
+
+// Bit-by-bit binary search, slow but obviously right
+static uint32_t naiveRoot(uint64_t v) {
+    uint64_t lo = 0, hi = 0xFFFFFFFFULL;
+    while (lo < hi) {
+        uint64_t mid = (lo + hi + 1) / 2;
+        if ((unsigned __int128)mid * mid <= v) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return (uint32_t)lo;
+}
+
+static uint64_t rng = 88172645463325252ULL;
+
+static uint64_t next() {
+    rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+    return rng;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_small_values_exhaustive() {
+    for (uint64_t v = 0; v <= 1000000; v++) {
+        TEST_ASSERT_EQUAL_UINT32(naiveRoot(v), isqrt64(v));
+    }
+}
+
+void test_around_perfect_squares() {
+    // Every root boundary is where an off-by-one would show
+    for (int t = 0; t < 100000; t++) {
+        uint64_t r = next() & 0xFFFFFFFFULL;
+        uint64_t square = r * r;
+        TEST_ASSERT_EQUAL_UINT32(r, isqrt64(square));
+        if (square > 0) TEST_ASSERT_EQUAL_UINT32(r - 1, isqrt64(square - 1));
+        if (r < 0xFFFFFFFFULL) TEST_ASSERT_EQUAL_UINT32(r, isqrt64(square + 2 * r));
+    }
+}
+
+void test_random_full_range() {
+    for (int t = 0; t < 100000; t++) {
+        uint64_t v = next() >> (next() & 63);
+        uint32_t r = isqrt64(v);
+        TEST_ASSERT_TRUE(isFloorRoot(v, r));
+        TEST_ASSERT_EQUAL_UINT32(naiveRoot(v), r);
+    }
+}
+
+void test_extremes() {
+    TEST_ASSERT_EQUAL_UINT32(0, isqrt64(0));
+    TEST_ASSERT_EQUAL_UINT32(1, isqrt64(1));
+    TEST_ASSERT_EQUAL_UINT32(1, isqrt64(3));
+    TEST_ASSERT_EQUAL_UINT32(2, isqrt64(4));
+    TEST_ASSERT_EQUAL_UINT32(0xFFFFFFFFUL, isqrt64(0xFFFFFFFFFFFFFFFFULL));
+    TEST_ASSERT_EQUAL_UINT32(0xFFFFFFFEUL, isqrt64(0xFFFFFFFE00000000ULL));
+    TEST_ASSERT_EQUAL_UINT32(0x80000000UL, isqrt64(1ULL << 62));
+    TEST_ASSERT_EQUAL_UINT32(0x7FFFFFFFUL, isqrt64((1ULL << 62) - 1));
+
+    // Largest centred sum CorrelationEngine can produce: 64k full-scale samples
+    uint64_t n = 65535;
+    uint64_t c = n * n * 32768ULL * 32768ULL;
+    TEST_ASSERT_TRUE(isFloorRoot(c, isqrt64(c)));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_small_values_exhaustive);
+    RUN_TEST(test_around_perfect_squares);
+    RUN_TEST(test_random_full_range);
+    RUN_TEST(test_extremes);
+    return UNITY_END();
+}
@@ -0,0 +1,179 @@
+// ============================================================================
+// test_lcd_framebuffer - Bus traffic of LcdFrameBuffer against a mock panel
+// ============================================================================
+#include <Arduino.h>
+#include <unity.h>
+#include "LcdFrameBuffer.h"
+
+// HD44780 stand-in: keeps the cells it was sent and counts every transfer,
+// so each test checks both what the panel shows and what it cost
+class MockLcd {
+public:
+    char cells[LcdFrameBuffer::ROWS][LcdFrameBuffer::COLS];
+    int row = 0;
+    int col = 0;
+    unsigned long cursorMoves = 0;
+    unsigned long dataWrites = 0;
+
+    MockLcd() { clear(); }
+
+    void clear() {
+        memset(cells, ' ', sizeof(cells));
+        row = col = 0;
+    }
+
+    void setCursor(int c, int r) {
+        col = c;
+        row = r;
+        cursorMoves++;
+    }
+
+    // The controller advances the cursor after every data byte
+    void write(char c) {
+        if (col < LcdFrameBuffer::COLS) cells[row][col] = c;
+        col++;
+        dataWrites++;
+    }
+
+    unsigned long transfers() const { return cursorMoves + dataWrites; }
+    void resetCounts() { cursorMoves = dataWrites = 0; }
+
+    bool shows(int r, const char* text) const {
+        char padded[LcdFrameBuffer::COLS];
+        memset(padded, ' ', sizeof(padded));
+        memcpy(padded, text, strnlen(text, LcdFrameBuffer::COLS));
+        return memcmp(cells[r], padded, sizeof(padded)) == 0;
+    }
+};
+
+// Naive redraw of a row: one cursor move plus every cell
+static const unsigned long NAIVE_ROW = 1 + LcdFrameBuffer::COLS;
+
+static LcdFrameBuffer frame;
+static MockLcd lcd;
+
+// Clock row as LcdTimeDisplay lays it out, "Mon 12:34:56 PM "
+static void clockRow(char* out, int seconds) {
+    int hours = seconds / 3600 % 24;
+    bool isPM = hours >= 12;
+    hours %= 12;
+    if (hours == 0) hours = 12;
+    snprintf(out, LcdFrameBuffer::COLS + 1, "Mon %2d:%02d:%02d %s", hours,
+             seconds / 60 % 60, seconds % 60, isPM ? "PM" : "AM");
+}
+
+static void showClock(int seconds) {
+    char row[LcdFrameBuffer::COLS + 1];
+    clockRow(row, seconds);
+    frame.writeLine(1, row);
+    frame.flush(lcd);
+    TEST_ASSERT_TRUE_MESSAGE(lcd.shows(1, row), row);
+}
+
+void setUp() {
+    lcd.clear();
+    frame.invalidate();
+    frame.writeLine(0, "Listening...");
+    showClock(12 * 3600 + 34 * 60 + 50);
+    lcd.resetCounts();
+}
+
+void tearDown() {}
+
+void test_tick_sends_only_the_seconds_digit() {
+    showClock(12 * 3600 + 34 * 60 + 51);
+    TEST_ASSERT_EQUAL_UINT32(1, lcd.cursorMoves);
+    TEST_ASSERT_EQUAL_UINT32(1, lcd.dataWrites);
+}
+
+void test_minute_rollover_bridges_the_colon() {
+    showClock(12 * 3600 + 34 * 60 + 59);
+    lcd.resetCounts();
+
+    // 12:34:59 -> 12:35:00: cells 8, 10 and 11 change; resending the ':'
+    // at 9 is cheaper than a second cursor move
+    showClock(12 * 3600 + 35 * 60);
+    TEST_ASSERT_EQUAL_UINT32(1, lcd.cursorMoves);
+    TEST_ASSERT_EQUAL_UINT32(4, lcd.dataWrites);
+}
+
+void test_an_hour_of_ticks_costs_two_transfers_a_tick() {
+    int start = 12 * 3600 + 34 * 60 + 50;
+    for (int s = 1; s <= 3600; s++) showClock(start + s);
+
+    unsigned long naive = 3600 * NAIVE_ROW;
+    char line[80];
+    snprintf(line, sizeof(line), "%lu transfers for 3600 ticks (naive %lu, %.1fx fewer)",
+             lcd.transfers(), naive, (float)naive / lcd.transfers());
+    TEST_MESSAGE(line);
+    // A tick is one cursor move and one digit, plus the odd carry
+    TEST_ASSERT_LESS_OR_EQUAL(3600 * 5 / 2, lcd.transfers());
+}
+
+void test_unchanged_status_sends_nothing() {
+    frame.writeLine(0, "Listening...");
+    TEST_ASSERT_FALSE(frame.isDirty());
+    frame.flush(lcd);
+    TEST_ASSERT_EQUAL_UINT32(0, lcd.transfers());
+}
+
+void test_status_change_sends_the_differing_cells() {
+    // "Listening..." -> "Listen: 4 digits": shared prefix stays put
+    frame.writeLine(0, "Listen: 4 digits");
+    frame.flush(lcd);
+    TEST_ASSERT_TRUE(lcd.shows(0, "Listen: 4 digits"));
+    TEST_ASSERT_EQUAL_UINT32(1, lcd.cursorMoves);
+    TEST_ASSERT_EQUAL_UINT32(10, lcd.dataWrites);
+    TEST_ASSERT_LESS_THAN(NAIVE_ROW, lcd.transfers());
+}
+
+void test_shorter_status_blanks_the_tail() {
+    frame.writeLine(0, "Listen");
+    frame.flush(lcd);
+    TEST_ASSERT_TRUE(lcd.shows(0, "Listen"));
+    TEST_ASSERT_EQUAL_UINT32(1, lcd.cursorMoves);
+    TEST_ASSERT_EQUAL_UINT32(6, lcd.dataWrites);
+}
+
+void test_status_toggle_back_restores_the_panel() {
+    frame.writeLine(0, "Recording");
+    frame.flush(lcd);
+    frame.writeLine(0, "Listening...");
+    frame.flush(lcd);
+    TEST_ASSERT_TRUE(lcd.shows(0, "Listening..."));
+    TEST_ASSERT_LESS_OR_EQUAL(2 * NAIVE_ROW, lcd.transfers());
+}
+
+void test_invalidate_after_clear_redraws_only_text() {
+    lcd.clear();
+    frame.invalidate();
+    frame.writeLine(0, "Voice Assistant");
+    frame.flush(lcd);
+    TEST_ASSERT_TRUE(lcd.shows(0, "Voice Assistant"));
+
+    // The cleared panel already shows the spaces, including the one at 5
+    TEST_ASSERT_EQUAL_UINT32(1, lcd.cursorMoves);
+    TEST_ASSERT_EQUAL_UINT32(15, lcd.dataWrites);
+}
+
+void test_bus_writes_match_the_driver() {
+    unsigned long before = frame.getBusWrites();
+    showClock(0);
+    frame.writeLine(0, "WiFi Failed!");
+    frame.flush(lcd);
+    TEST_ASSERT_EQUAL_UINT32(lcd.transfers(), frame.getBusWrites() - before);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_tick_sends_only_the_seconds_digit);
+    RUN_TEST(test_minute_rollover_bridges_the_colon);
+    RUN_TEST(test_an_hour_of_ticks_costs_two_transfers_a_tick);
+    RUN_TEST(test_unchanged_status_sends_nothing);
+    RUN_TEST(test_status_change_sends_the_differing_cells);
+    RUN_TEST(test_shorter_status_blanks_the_tail);
+    RUN_TEST(test_status_toggle_back_restores_the_panel);
+    RUN_TEST(test_invalidate_after_clear_redraws_only_text);
+    RUN_TEST(test_bus_writes_match_the_driver);
+    return UNITY_END();
+}
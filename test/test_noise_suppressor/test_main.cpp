@@ -0,0 +1,157 @@
+// ============================================================================
+// test_noise_suppressor - Upload-path alignment, lead-in and per-frame cost
+// ============================================================================
+#include <Arduino.h>
+#include <unity.h>
+#include "NoiseSuppressor.h"
+#include "SignalSynth.h"
+
+// Streams a 3 s upload through the suppressor the way WIT_loop does:
+// capture-sized chunks, lead-in dropped, tail flushed at the end
+
+static const int LENGTH = 48000;
+static const int CHUNK = 100;
+
+static int16_t input[LENGTH];
+static int16_t output[LENGTH];
+static SignalSynth synth;
+static NoiseSuppressor denoiser;
+
+static void store(const int16_t* samples, int count, int streamIndex) {
+    for (int i = 0; i < count; i++) {
+        int k = streamIndex + i - NoiseSuppressor::LATENCY;
+        if (k >= 0) output[k] = samples[i];
+    }
+}
+
+static void runUpload() {
+    denoiser.restart();
+    memset(output, 0x55, sizeof(output));
+
+    int16_t chunk[CHUNK];
+    for (int i = 0; i < LENGTH; i += CHUNK) {
+        memcpy(chunk, input + i, sizeof(chunk));
+        denoiser.process(chunk, CHUNK);
+        store(chunk, CHUNK, i);
+    }
+    int16_t tail[NoiseSuppressor::LATENCY];
+    TEST_ASSERT_EQUAL_INT(NoiseSuppressor::LATENCY, denoiser.flush(tail));
+    store(tail, NoiseSuppressor::LATENCY, LENGTH);
+}
+
+static float rms(const int16_t* samples, int start, int count) {
+    double sum = 0;
+    for (int i = start; i < start + count; i++) sum += (double)samples[i] * samples[i];
+    return sqrt(sum / count);
+}
+
+static double correlationAt(int lag) {
+    double sum = 0;
+    for (int i = 1000; i < LENGTH - 1000; i++) sum += (double)input[i] * output[i + lag];
+    return sum;
+}
+
+static void fillNoise(float rmsDb) {
+    for (int i = 0; i < LENGTH; i++) {
+        input[i] = (int16_t)synth.gaussian(SignalSynth::amplitude(rmsDb));
+    }
+}
+
+void setUp() {
+    synth.seed(1);
+    denoiser.reset();
+}
+
+void tearDown() {}
+
+void test_output_lines_up_with_input() {
+    fillNoise(-30);
+    for (int i = 16000; i < 24000; i++) {
+        input[i] += (int16_t)(SignalSynth::amplitude(-12) * sin(2 * PI * 440 * i / 16000.0));
+    }
+    runUpload();
+
+    int best = 0;
+    for (int lag = -300; lag <= 300; lag++) {
+        if (correlationAt(lag) > correlationAt(best)) best = lag;
+    }
+    TEST_ASSERT_EQUAL_INT(0, best);
+}
+
+void test_tail_is_flushed() {
+    fillNoise(-30);
+    for (int i = LENGTH - 2000; i < LENGTH; i++) {
+        input[i] = (int16_t)(SignalSynth::amplitude(-12) * sin(2 * PI * 1000 * i / 16000.0));
+    }
+    runUpload();
+
+    // The last 256 samples used to stay behind in the overlap-add
+    float in = rms(input, LENGTH - NoiseSuppressor::LATENCY, NoiseSuppressor::LATENCY);
+    float out = rms(output, LENGTH - NoiseSuppressor::LATENCY, NoiseSuppressor::LATENCY);
+    TEST_ASSERT_GREATER_THAN(0.5f * in, out);
+    TEST_ASSERT_LESS_THAN(1.5f * in, out);
+}
+
+void test_first_frame_has_no_transient() {
+    // Steady noise: no click at the start, and the opening samples are not
+    // buried while the gains settle
+    fillNoise(-30);
+    runUpload();
+
+    int peakIn = 0, peakOut = 0;
+    for (int i = 0; i < NoiseSuppressor::HOP; i++) {
+        peakIn = max(peakIn, abs(input[i]));
+        peakOut = max(peakOut, abs(output[i]));
+    }
+    TEST_ASSERT_LESS_OR_EQUAL(peakIn, peakOut);
+
+    float head = rms(output, 0, NoiseSuppressor::HOP);
+    float steady = rms(output, 8000, 8000);
+    char line[64];
+    snprintf(line, sizeof(line), "head %.1f, steady %.1f", head, steady);
+    TEST_MESSAGE(line);
+    TEST_ASSERT_LESS_THAN(1.5f * steady, head);
+    TEST_ASSERT_GREATER_THAN(0.4f * steady, head);
+}
+
+void test_speech_band_kept_noise_reduced() {
+    fillNoise(-40);
+    for (int i = 24000; i < 32000; i++) {
+        input[i] += (int16_t)(SignalSynth::amplitude(-12) * sin(2 * PI * 700 * i / 16000.0));
+    }
+    runUpload();
+
+    float noiseGain = rms(output, 8000, 8000) / rms(input, 8000, 8000);
+    float toneGain = rms(output, 26000, 4000) / rms(input, 26000, 4000);
+    char line[64];
+    snprintf(line, sizeof(line), "noise x%.2f, tone x%.2f", noiseGain, toneGain);
+    TEST_MESSAGE(line);
+    TEST_ASSERT_LESS_THAN(0.5f, noiseGain);      // At least 6 dB off white noise
+    TEST_ASSERT_GREATER_THAN(0.7f, toneGain);
+}
+
+void test_frame_cost_fits_the_hop() {
+    fillNoise(-30);
+    runUpload();
+
+    // One frame per HOP samples, lead-in and flush included
+    TEST_ASSERT_EQUAL_UINT32((LENGTH + NoiseSuppressor::LATENCY) / NoiseSuppressor::HOP,
+                             denoiser.getFrameCount());
+
+    uint32_t hopMicros = NoiseSuppressor::HOP * 1000000UL / 16000;
+    char line[80];
+    snprintf(line, sizeof(line), "max frame %lu us of a %lu us hop",
+             (unsigned long)denoiser.getMaxFrameMicros(), (unsigned long)hopMicros);
+    TEST_MESSAGE(line);
+    TEST_ASSERT_LESS_THAN(hopMicros, denoiser.getMaxFrameMicros());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_output_lines_up_with_input);
+    RUN_TEST(test_tail_is_flushed);
+    RUN_TEST(test_first_frame_has_no_transient);
+    RUN_TEST(test_speech_band_kept_noise_reduced);
+    RUN_TEST(test_frame_cost_fits_the_hop);
+    return UNITY_END();
+}
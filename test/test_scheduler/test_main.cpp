@@ -0,0 +1,198 @@
+// ============================================================================
+// test_scheduler - Timer ordering, cancel and periodic phase on a virtual clock
+// ============================================================================
+#include <Arduino.h>
+#include <unity.h>
+#include <string>
+#include "Scheduler.h"
+
+static uint32_t virtualNow = 0;
+
+static uint32_t virtualClock() {
+    return virtualNow;
+}
+
+static Scheduler scheduler(virtualClock);
+static std::string fired;
+
+// Each timer's context is the label it appends when it fires
+static void record(void* context) {
+    fired += static_cast<const char*>(context);
+}
+
+// Steps the clock one millisecond at a time, ticking on each, the way
+// loop() drives the scheduler
+static void advance(uint32_t ms) {
+    for (uint32_t i = 0; i < ms; i++) {
+        virtualNow++;
+        scheduler.tick();
+    }
+}
+
+static void cancelAll() {
+    for (Scheduler::TimerId id = 0; id < 32; id++) scheduler.cancel(id);
+}
+
+void setUp() {
+    cancelAll();
+    virtualNow = 1000;
+    fired.clear();
+}
+
+void tearDown() {}
+
+void test_one_shot_fires_once_when_due() {
+    Scheduler::TimerId id = scheduler.after(50, record, (void*)"a");
+    advance(49);
+    TEST_ASSERT_EQUAL_STRING("", fired.c_str());
+    TEST_ASSERT_TRUE(scheduler.isPending(id));
+
+    advance(1);
+    TEST_ASSERT_EQUAL_STRING("a", fired.c_str());
+    TEST_ASSERT_FALSE(scheduler.isPending(id));
+
+    advance(200);
+    TEST_ASSERT_EQUAL_STRING("a", fired.c_str());
+}
+
+void test_timers_fire_in_due_order() {
+    scheduler.after(30, record, (void*)"3");
+    scheduler.after(10, record, (void*)"1");
+    scheduler.after(20, record, (void*)"2");
+    advance(30);
+    TEST_ASSERT_EQUAL_STRING("123", fired.c_str());
+}
+
+void test_late_tick_keeps_due_order() {
+    // Slots are taken in arming order, the reverse of due order
+    scheduler.after(30, record, (void*)"3");
+    scheduler.after(20, record, (void*)"2");
+    scheduler.after(10, record, (void*)"1");
+
+    virtualNow += 500;
+    scheduler.tick();
+    TEST_ASSERT_EQUAL_STRING("123", fired.c_str());
+}
+
+void test_equal_due_times_fire_in_arming_order() {
+    scheduler.after(10, record, (void*)"a");
+    scheduler.after(10, record, (void*)"b");
+    scheduler.after(10, record, (void*)"c");
+    advance(10);
+    TEST_ASSERT_EQUAL_STRING("abc", fired.c_str());
+}
+
+void test_cancelled_timer_never_fires() {
+    Scheduler::TimerId id = scheduler.after(10, record, (void*)"x");
+    scheduler.after(20, record, (void*)"y");
+    advance(5);
+    scheduler.cancel(id);
+    TEST_ASSERT_FALSE(scheduler.isPending(id));
+
+    advance(50);
+    TEST_ASSERT_EQUAL_STRING("y", fired.c_str());
+}
+
+static Scheduler::TimerId victim = Scheduler::INVALID_TIMER;
+
+static void cancelVictim(void* context) {
+    record(context);
+    scheduler.cancel(victim);
+}
+
+void test_callback_can_cancel_a_timer_due_in_the_same_tick() {
+    scheduler.after(10, cancelVictim, (void*)"k");
+    victim = scheduler.after(20, record, (void*)"v");
+
+    virtualNow += 100;
+    scheduler.tick();
+    TEST_ASSERT_EQUAL_STRING("k", fired.c_str());
+}
+
+static void rearm(void* context) {
+    record(context);
+    scheduler.after(0, record, (void*)"r");
+}
+
+void test_timer_armed_by_a_callback_waits_for_the_next_tick() {
+    scheduler.after(10, rearm, (void*)"a");
+    advance(10);
+    TEST_ASSERT_EQUAL_STRING("a", fired.c_str());
+
+    scheduler.tick();
+    TEST_ASSERT_EQUAL_STRING("ar", fired.c_str());
+}
+
+void test_periodic_keeps_its_phase() {
+    scheduler.every(100, record, (void*)".");
+    advance(1000);
+    TEST_ASSERT_EQUAL_STRING("..........", fired.c_str());
+
+    // Ticking late fires the tick that was due, still on the 100 ms grid
+    fired.clear();
+    virtualNow += 130;
+    scheduler.tick();
+    advance(69);
+    TEST_ASSERT_EQUAL_STRING(".", fired.c_str());
+    advance(1);
+    TEST_ASSERT_EQUAL_STRING("..", fired.c_str());
+}
+
+void test_periodic_skips_missed_periods() {
+    scheduler.every(100, record, (void*)".");
+
+    // Half a second stalled: one catch-up call, not five
+    virtualNow += 550;
+    scheduler.tick();
+    TEST_ASSERT_EQUAL_STRING(".", fired.c_str());
+
+    // Re-phased from the late tick
+    advance(99);
+    TEST_ASSERT_EQUAL_STRING(".", fired.c_str());
+    advance(1);
+    TEST_ASSERT_EQUAL_STRING("..", fired.c_str());
+}
+
+void test_cancelled_periodic_stops() {
+    Scheduler::TimerId id = scheduler.every(10, record, (void*)".");
+    advance(30);
+    scheduler.cancel(id);
+    advance(100);
+    TEST_ASSERT_EQUAL_STRING("...", fired.c_str());
+}
+
+void test_due_time_survives_clock_wraparound() {
+    virtualNow = 0xFFFFFFF0UL;
+    scheduler.after(32, record, (void*)"w");
+    advance(31);
+    TEST_ASSERT_EQUAL_STRING("", fired.c_str());
+    advance(1);
+    TEST_ASSERT_EQUAL_STRING("w", fired.c_str());
+}
+
+void test_full_table_refuses_new_timers() {
+    int armed = 0;
+    while (scheduler.after(1000, record, (void*)"f") != Scheduler::INVALID_TIMER) armed++;
+    TEST_ASSERT_EQUAL_INT(16, armed);
+
+    // A freed slot is reused
+    scheduler.cancel(3);
+    TEST_ASSERT_EQUAL_INT(3, scheduler.after(10, record, (void*)"s"));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_one_shot_fires_once_when_due);
+    RUN_TEST(test_timers_fire_in_due_order);
+    RUN_TEST(test_late_tick_keeps_due_order);
+    RUN_TEST(test_equal_due_times_fire_in_arming_order);
+    RUN_TEST(test_cancelled_timer_never_fires);
+    RUN_TEST(test_callback_can_cancel_a_timer_due_in_the_same_tick);
+    RUN_TEST(test_timer_armed_by_a_callback_waits_for_the_next_tick);
+    RUN_TEST(test_periodic_keeps_its_phase);
+    RUN_TEST(test_periodic_skips_missed_periods);
+    RUN_TEST(test_cancelled_periodic_stops);
+    RUN_TEST(test_due_time_survives_clock_wraparound);
+    RUN_TEST(test_full_table_refuses_new_timers);
+    return UNITY_END();
+}
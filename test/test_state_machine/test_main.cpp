@@ -0,0 +1,221 @@
+// ============================================================================
+// test_state_machine - Transition order and timer-driven states
+// ============================================================================
+#include <Arduino.h>
+#include <unity.h>
+#include <string>
+#include "Scheduler.h"
+#include "StateMachine.h"
+
+static uint32_t virtualNow = 0;
+
+static uint32_t virtualClock() {
+    return virtualNow;
+}
+
+static Scheduler scheduler(virtualClock);
+static StateMachine* machine = nullptr;
+static std::string trace;
+
+// Logs its hooks as "<name>+", "<name>.", "<name>-"; optionally requests a
+// transition from enter() or tick()
+class TracedState : public State {
+private:
+    const char* label;
+
+public:
+    State* nextOnEnter = nullptr;
+    State* nextOnTick = nullptr;
+
+    explicit TracedState(const char* label) : label(label) {}
+
+    const char* name() override { return label; }
+
+    void enter() override {
+        trace += label;
+        trace += '+';
+        if (nextOnEnter) machine->transitionTo(nextOnEnter);
+    }
+
+    void tick() override {
+        trace += label;
+        trace += '.';
+        if (nextOnTick) machine->transitionTo(nextOnTick);
+    }
+
+    void exit() override {
+        trace += label;
+        trace += '-';
+    }
+};
+
+// Waits for input like the code-entry states: a periodic blink while
+// active, and a timeout that hands over to another state
+class TimedState : public TracedState {
+private:
+    Scheduler::TimerId blinkTimer = Scheduler::INVALID_TIMER;
+    Scheduler::TimerId timeoutTimer = Scheduler::INVALID_TIMER;
+
+    static void onBlink(void* context) {
+        static_cast<TimedState*>(context)->blinks++;
+    }
+
+    static void onTimeout(void* context) {
+        machine->transitionTo(static_cast<TimedState*>(context)->onExpiry);
+    }
+
+public:
+    State* onExpiry = nullptr;
+    int blinks = 0;
+
+    explicit TimedState(const char* label) : TracedState(label) {}
+
+    void enter() override {
+        TracedState::enter();
+        blinks = 0;
+        blinkTimer = scheduler.every(500, onBlink, this);
+        timeoutTimer = scheduler.after(2000, onTimeout, this);
+    }
+
+    void exit() override {
+        scheduler.cancel(blinkTimer);
+        scheduler.cancel(timeoutTimer);
+        blinkTimer = timeoutTimer = Scheduler::INVALID_TIMER;
+        TracedState::exit();
+    }
+
+    bool timersPending() {
+        return scheduler.isPending(blinkTimer) || scheduler.isPending(timeoutTimer);
+    }
+};
+
+// loop(): timers first, then the machine
+static void loopFor(uint32_t ms) {
+    for (uint32_t i = 0; i < ms; i++) {
+        virtualNow++;
+        scheduler.tick();
+        machine->tick();
+    }
+}
+
+static TracedState idle("I");
+static TracedState listen("L");
+static TracedState busy("B");
+
+void setUp() {
+    delete machine;
+    machine = new StateMachine();
+    idle.nextOnEnter = idle.nextOnTick = nullptr;
+    listen.nextOnEnter = listen.nextOnTick = nullptr;
+    busy.nextOnEnter = busy.nextOnTick = nullptr;
+    virtualNow = 0;
+    trace.clear();
+}
+
+void tearDown() {}
+
+void test_transition_applies_on_next_tick() {
+    machine->transitionTo(&idle);
+    TEST_ASSERT_NULL(machine->getCurrent());
+    TEST_ASSERT_EQUAL_STRING("", trace.c_str());
+
+    machine->tick();
+    TEST_ASSERT_TRUE(machine->isIn(&idle));
+    TEST_ASSERT_EQUAL_STRING("I+I.", trace.c_str());
+}
+
+void test_exit_runs_before_enter() {
+    machine->transitionTo(&idle);
+    machine->tick();
+    trace.clear();
+
+    machine->transitionTo(&listen);
+    machine->tick();
+    TEST_ASSERT_EQUAL_STRING("I-L+L.", trace.c_str());
+}
+
+void test_transition_from_tick_applies_before_the_next_tick() {
+    idle.nextOnTick = &listen;
+    machine->transitionTo(&idle);
+    machine->tick();
+
+    // The old state's tick ran, then the switch, with no tick in between
+    TEST_ASSERT_EQUAL_STRING("I+I.I-L+", trace.c_str());
+    TEST_ASSERT_TRUE(machine->isIn(&listen));
+}
+
+void test_last_request_wins() {
+    machine->transitionTo(&idle);
+    machine->transitionTo(&busy);
+    machine->tick();
+    TEST_ASSERT_EQUAL_STRING("B+B.", trace.c_str());
+}
+
+void test_enter_can_chain_a_transition() {
+    idle.nextOnEnter = &listen;
+    machine->transitionTo(&idle);
+    machine->tick();
+    TEST_ASSERT_EQUAL_STRING("I+I-L+L.", trace.c_str());
+}
+
+void test_chain_is_cut_short_and_resumed_later() {
+    // A cycle of enter() requests would otherwise never return
+    idle.nextOnEnter = &listen;
+    listen.nextOnEnter = &busy;
+    busy.nextOnEnter = &idle;
+    machine->transitionTo(&idle);
+    machine->tick();
+
+    // Four transitions before the tick, four after
+    TEST_ASSERT_EQUAL_STRING("I+I-L+L-B+B-I+I.I-L+L-B+B-I+I-L+", trace.c_str());
+}
+
+void test_timeout_hands_over_and_exit_cancels_timers() {
+    TimedState verify("V");
+    verify.onExpiry = &idle;
+    machine->transitionTo(&verify);
+    machine->tick();
+    trace.clear();
+
+    loopFor(1999);
+    TEST_ASSERT_TRUE(machine->isIn(&verify));
+    TEST_ASSERT_EQUAL_INT(3, verify.blinks);
+
+    // The 2 s timeout and the fourth blink are due on the same tick
+    loopFor(1);
+    TEST_ASSERT_TRUE(machine->isIn(&idle));
+    TEST_ASSERT_EQUAL_INT(4, verify.blinks);
+    TEST_ASSERT_FALSE(verify.timersPending());
+
+    loopFor(5000);
+    TEST_ASSERT_EQUAL_INT(4, verify.blinks);
+}
+
+void test_leaving_early_cancels_the_timeout() {
+    TimedState verify("V");
+    verify.onExpiry = &busy;
+    machine->transitionTo(&verify);
+    loopFor(700);
+
+    machine->transitionTo(&listen);
+    loopFor(5000);
+    TEST_ASSERT_TRUE(machine->isIn(&listen));
+    TEST_ASSERT_EQUAL_INT(1, verify.blinks);
+    TEST_ASSERT_FALSE(verify.timersPending());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_transition_applies_on_next_tick);
+    RUN_TEST(test_exit_runs_before_enter);
+    RUN_TEST(test_transition_from_tick_applies_before_the_next_tick);
+    RUN_TEST(test_last_request_wins);
+    RUN_TEST(test_enter_can_chain_a_transition);
+    RUN_TEST(test_chain_is_cut_short_and_resumed_later);
+    RUN_TEST(test_timeout_hands_over_and_exit_cancels_timers);
+    RUN_TEST(test_leaving_early_cancels_the_timeout);
+    int failures = UNITY_END();
+
+    delete machine;
+    return failures;
+}
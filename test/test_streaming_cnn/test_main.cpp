@@ -0,0 +1,134 @@
+// ============================================================================
+// test_streaming_cnn - Column-cached CNN against full passes and TFLite
+// ============================================================================
+#include <Arduino.h>
+#include <unity.h>
+#include "NeuralNetwork.h"
+#include "StreamingCnn.h"
+#include "happy_model.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+
+// A seeded feature stream slides under the model a hop at a time. Each
+// streamed score must match a full pass over the same window exactly (the
+// rows are summed in the same order either way) and the interpreter to
+// float tolerance (its kernels sum in their own order).
+
+static const int HOPS = 12;
+static const int MAX_HOP = 40;
+static const int STREAM_FRAMES = N_FRAMES + HOPS * MAX_HOP;
+static const float INTERPRETER_TOLERANCE = 1e-4f;
+
+static float stream[STREAM_FRAMES][N_MFCC];
+static StreamingCnn streaming;
+static StreamingCnn full;
+static NeuralNetwork* nn = nullptr;
+
+// MFCC-sized values: c0 carries the log energy, the rest sit near zero
+static void fillStream() {
+    uint32_t seed = 1;
+    for (int t = 0; t < STREAM_FRAMES; t++) {
+        for (int m = 0; m < N_MFCC; m++) {
+            seed = seed * 1664525u + 1013904223u;
+            float unit = (int32_t)(seed >> 8) / 8388608.0f - 1.0f;
+            stream[t][m] = m == 0 ? 40.0f + 20.0f * unit : 8.0f * unit;
+        }
+    }
+}
+
+static const float* windowAt(int frame) {
+    return &stream[frame][0];
+}
+
+static float interpreterScore(const float* window) {
+    memcpy(nn->getInputBuffer(), window, N_FRAMES * N_MFCC * sizeof(float));
+    return nn->predict();
+}
+
+// Slides by hop frames HOPS times; every score checked against a full pass
+static void assertStreamsLikeFullPasses(int hop) {
+    TEST_ASSERT_TRUE(hop <= MAX_HOP);
+    streaming.invalidate();
+    streaming.predict(windowAt(0), N_FRAMES);
+
+    for (int step = 1; step <= HOPS; step++) {
+        const float* window = windowAt(step * hop);
+        float score = streaming.predict(window, hop);
+        TEST_ASSERT_TRUE(streaming.getLastMacs() < streaming.getFullMacs());
+
+        float expected = full.predict(window, N_FRAMES);
+        TEST_ASSERT_EQUAL_MEMORY(&expected, &score, sizeof(score));
+        TEST_ASSERT_FLOAT_WITHIN(INTERPRETER_TOLERANCE, interpreterScore(window), score);
+    }
+
+    char line[80];
+    snprintf(line, sizeof(line), "hop %d: %lu of %lu MACs per window", hop,
+             (unsigned long)streaming.getLastMacs(), (unsigned long)streaming.getFullMacs());
+    TEST_MESSAGE(line);
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_binds_to_the_shipped_model() {
+    TEST_ASSERT_TRUE(streaming.isReady());
+    TEST_ASSERT_TRUE(full.isReady());
+    TEST_ASSERT_NOT_NULL(nn->getStreaming());
+}
+
+void test_full_pass_matches_interpreter() {
+    for (int frame = 0; frame < STREAM_FRAMES - N_FRAMES; frame += 97) {
+        float score = full.predict(windowAt(frame), N_FRAMES);
+        TEST_ASSERT_FLOAT_WITHIN(INTERPRETER_TOLERANCE, interpreterScore(windowAt(frame)), score);
+    }
+}
+
+void test_hop_4() {
+    assertStreamsLikeFullPasses(4);
+}
+
+void test_hop_8() {
+    assertStreamsLikeFullPasses(8);
+}
+
+void test_hop_20() {
+    assertStreamsLikeFullPasses(20);
+}
+
+void test_hop_40() {
+    // The wake pipeline's hop: WAKE_HOP through the pitch stretch
+    assertStreamsLikeFullPasses(40);
+}
+
+void test_hop_not_multiple_of_decimation_runs_full_pass() {
+    streaming.invalidate();
+    streaming.predict(windowAt(0), N_FRAMES);
+
+    for (int hop = 1; hop < 2 * StreamingCnn::DECIMATION; hop++) {
+        if (hop % StreamingCnn::DECIMATION == 0) continue;
+        float score = streaming.predict(windowAt(hop), hop);
+        float expected = full.predict(windowAt(hop), N_FRAMES);
+        TEST_ASSERT_EQUAL_UINT32(full.getLastMacs(), streaming.getLastMacs());
+        TEST_ASSERT_EQUAL_MEMORY(&expected, &score, sizeof(score));
+    }
+}
+
+int main(int argc, char** argv) {
+    fillStream();
+    const tflite::Model* model = tflite::GetModel(happy_model);
+    streaming.begin(model);
+    full.begin(model);
+    nn = new NeuralNetwork();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_binds_to_the_shipped_model);
+    RUN_TEST(test_full_pass_matches_interpreter);
+    RUN_TEST(test_hop_4);
+    RUN_TEST(test_hop_8);
+    RUN_TEST(test_hop_20);
+    RUN_TEST(test_hop_40);
+    RUN_TEST(test_hop_not_multiple_of_decimation_runs_full_pass);
+    int failures = UNITY_END();
+
+    delete nn;
+    return failures;
+}
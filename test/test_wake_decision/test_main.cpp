@@ -0,0 +1,69 @@
+// ============================================================================
+// test_wake_decision - Operating points of the wake-word trigger modes
+// ============================================================================
+#include <Arduino.h>
+#include <unity.h>
+#include "WakeDecision.h"
+
+// One score per WAKE_HOP window, 250 ms apart
+static const uint32_t HOP_MS = 250;
+
+static WakeDecision decision;
+static uint32_t now = 0;
+
+static bool feed(float score) {
+    now += HOP_MS;
+    return decision.update(score, now);
+}
+
+void setUp() {
+    now = 0;
+    decision.setMode(WakeDecision::STRICT);
+    decision.reset();
+}
+
+void tearDown() {}
+
+void test_strict_fires_on_one_window_above_0_999() {
+    // The pre-k-of-n operating point: a single raw score, strictly above
+    TEST_ASSERT_FALSE(feed(0.5f));
+    TEST_ASSERT_FALSE(feed(0.999f));
+    TEST_ASSERT_TRUE(feed(0.9995f));
+}
+
+void test_strict_ignores_near_misses() {
+    for (int i = 0; i < 40; i++) {
+        TEST_ASSERT_FALSE(feed(0.998f));
+    }
+}
+
+void test_relaxed_averages_pairs() {
+    decision.setMode(WakeDecision::RELAXED);
+
+    // A lone spike is averaged with the window before it
+    TEST_ASSERT_FALSE(feed(0.2f));
+    TEST_ASSERT_FALSE(feed(0.99f));
+    TEST_ASSERT_FALSE(feed(0.3f));
+
+    TEST_ASSERT_FALSE(feed(0.89f));
+    TEST_ASSERT_TRUE(feed(0.95f));
+}
+
+void test_refractory_after_a_trigger() {
+    TEST_ASSERT_TRUE(feed(1.0f));
+
+    // Seven hops are inside the 2 s period, the eighth is past it
+    for (int i = 0; i < 7; i++) {
+        TEST_ASSERT_FALSE(feed(1.0f));
+    }
+    TEST_ASSERT_TRUE(feed(1.0f));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_strict_fires_on_one_window_above_0_999);
+    RUN_TEST(test_strict_ignores_near_misses);
+    RUN_TEST(test_relaxed_averages_pairs);
+    RUN_TEST(test_refractory_after_a_trigger);
+    return UNITY_END();
+}
@@ -0,0 +1,201 @@
+// ============================================================================
+// test_worker_pool - N-worker pool, the parallel Conv2D and the streaming
+// CNN's rows, with speedups
+// ============================================================================
+#include <Arduino.h>
+#include <unity.h>
+#include <atomic>
+#include <thread>
+#include "WorkerPool.h"
+#include "ParallelConv.h"
+#include "StreamingCnn.h"
+#include "happy_model.h"
+#include "tensorflow/lite/micro/micro_mutable_op_resolver.h"
+#include "tensorflow/lite/micro/micro_error_reporter.h"
+#include "tensorflow/lite/micro/micro_interpreter.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+
+// Helpers are host threads here (the native env raises MAX_HELPERS), so
+// the pool runs with 1..N workers. Every run is checked against a serial
+// reference bit for bit; the speedups are measured, not asserted, since
+// they depend on the cores the host has to give.
+
+static const int ARENA_SIZE = 20000;
+static const int PASSES = 200;
+
+static int maxWorkers() {
+    int cores = (int)std::thread::hardware_concurrency();
+    int workers = cores > 2 ? cores : 2;        // Two even on one core: the barrier still runs
+    return workers < WorkerPool::MAX_HELPERS + 1 ? workers : WorkerPool::MAX_HELPERS + 1;
+}
+
+// --- Pool on its own ---------------------------------------------------------
+
+static const int ITEMS = 997;
+static std::atomic<int> visits[ITEMS];
+
+static void visit(void* context, int item) {
+    visits[item]++;
+}
+
+// --- The model, stock kernel vs the pool's ----------------------------------
+
+struct ModelRun {
+    tflite::MicroErrorReporter reporter;
+    tflite::MicroMutableOpResolver<10> resolver;
+    uint8_t arena[ARENA_SIZE];
+    tflite::MicroInterpreter* interpreter = nullptr;
+
+    explicit ModelRun(WorkerPool* workers) {
+        const tflite::Model* model = tflite::GetModel(happy_model);
+        if (workers) {
+            resolver.AddConv2D(Register_PARALLEL_CONV_2D(workers));
+        } else {
+            resolver.AddConv2D();
+        }
+        resolver.AddMaxPool2D();
+        resolver.AddFullyConnected();
+        resolver.AddLogistic();
+        resolver.AddQuantize();
+        resolver.AddDequantize();
+        resolver.AddMean();
+        resolver.AddReshape();
+        interpreter = new tflite::MicroInterpreter(model, resolver, arena, ARENA_SIZE, &reporter);
+        TEST_ASSERT_EQUAL(kTfLiteOk, interpreter->AllocateTensors());
+    }
+
+    ~ModelRun() { delete interpreter; }
+
+    // Scores PASSES seeded windows; returns the time taken
+    uint32_t score(float* scores) {
+        TfLiteTensor* input = interpreter->input(0);
+        int length = input->bytes / sizeof(float);
+        uint32_t seed = 1;
+        uint32_t elapsed = 0;
+        for (int pass = 0; pass < PASSES; pass++) {
+            for (int i = 0; i < length; i++) {
+                seed = seed * 1664525u + 1013904223u;
+                input->data.f[i] = (int32_t)(seed >> 8) / 8388608.0f - 1.0f;
+            }
+            uint32_t start = micros();
+            TEST_ASSERT_EQUAL(kTfLiteOk, interpreter->Invoke());
+            elapsed += micros() - start;
+            scores[pass] = interpreter->output(0)->data.f[0];
+        }
+        return elapsed;
+    }
+};
+
+static float reference[PASSES];
+static float parallel[PASSES];
+
+void setUp() {}
+void tearDown() {}
+
+void test_every_item_runs_once_for_any_worker_count() {
+    for (int workers = 1; workers <= maxWorkers(); workers++) {
+        WorkerPool pool;
+        if (workers > 1) TEST_ASSERT_TRUE(pool.begin(workers - 1, 0, 1));
+        TEST_ASSERT_EQUAL_INT(workers, pool.getWorkers());
+
+        for (int run = 0; run < 50; run++) {
+            for (int i = 0; i < ITEMS; i++) visits[i] = 0;
+            pool.run(visit, nullptr, ITEMS);
+            for (int i = 0; i < ITEMS; i++) TEST_ASSERT_EQUAL_INT(1, visits[i].load());
+        }
+        TEST_ASSERT_EQUAL_UINT32(50 * ITEMS, pool.getStats().items);
+        if (workers == 1) TEST_ASSERT_EQUAL_UINT32(0, pool.getStats().helperItems);
+    }
+}
+
+void test_parallel_conv_matches_stock_and_reports_speedup() {
+    ModelRun stock(nullptr);
+    uint32_t serialMicros = stock.score(reference);
+
+    char line[120];
+    snprintf(line, sizeof(line), "%d host cores; stock kernel %lu us per pass",
+             (int)std::thread::hardware_concurrency(), (unsigned long)(serialMicros / PASSES));
+    TEST_MESSAGE(line);
+
+    for (int workers = 1; workers <= maxWorkers(); workers++) {
+        WorkerPool pool;
+        if (workers > 1) TEST_ASSERT_TRUE(pool.begin(workers - 1, 0, 1));
+
+        ModelRun run(&pool);
+        uint32_t elapsed = run.score(parallel);
+        TEST_ASSERT_EQUAL_MEMORY(reference, parallel, sizeof(reference));
+
+        const WorkerPool::Stats& stats = pool.getStats();
+        snprintf(line, sizeof(line), "%d workers: %lu us per pass, x%.2f, helpers took %lu of %lu rows",
+                 workers, (unsigned long)(elapsed / PASSES), (double)serialMicros / elapsed,
+                 (unsigned long)stats.helperItems, (unsigned long)stats.items);
+        TEST_MESSAGE(line);
+    }
+}
+
+// --- The streaming CNN, serial rows vs the pool's ----------------------------
+
+static const int STREAM_HOP = 40;           // The wake pipeline's hop in MFCC rows
+static const int STREAM_FRAMES = N_FRAMES + PASSES * STREAM_HOP / 4;
+static float stream[STREAM_FRAMES][N_MFCC];
+
+// Full pass, then windows sliding by STREAM_HOP (wrapping around the
+// stream); returns the time taken by the streamed passes
+static uint32_t streamScores(WorkerPool* workers, float* scores) {
+    static StreamingCnn cnn;
+    TEST_ASSERT_TRUE(cnn.begin(tflite::GetModel(happy_model)));
+    cnn.setWorkers(workers);
+    cnn.predict(&stream[0][0], N_FRAMES);
+
+    uint32_t elapsed = 0;
+    int frame = 0;
+    for (int pass = 0; pass < PASSES; pass++) {
+        frame += STREAM_HOP;
+        if (frame + N_FRAMES > STREAM_FRAMES) frame = 0;
+        int newFrames = frame == 0 ? N_FRAMES : STREAM_HOP;
+
+        uint32_t start = micros();
+        scores[pass] = cnn.predict(&stream[frame][0], newFrames);
+        elapsed += micros() - start;
+    }
+    return elapsed;
+}
+
+void test_streaming_rows_match_serial_and_report_speedup() {
+    uint32_t serialMicros = streamScores(nullptr, reference);
+
+    char line[120];
+    snprintf(line, sizeof(line), "streaming, hop %d: serial rows %lu us per pass",
+             STREAM_HOP, (unsigned long)(serialMicros / PASSES));
+    TEST_MESSAGE(line);
+
+    for (int workers = 1; workers <= maxWorkers(); workers++) {
+        WorkerPool pool;
+        if (workers > 1) TEST_ASSERT_TRUE(pool.begin(workers - 1, 0, 1));
+
+        uint32_t elapsed = streamScores(&pool, parallel);
+        TEST_ASSERT_EQUAL_MEMORY(reference, parallel, sizeof(reference));
+
+        const WorkerPool::Stats& stats = pool.getStats();
+        snprintf(line, sizeof(line), "%d workers: %lu us per pass, x%.2f, helpers took %lu of %lu rows",
+                 workers, (unsigned long)(elapsed / PASSES), (double)serialMicros / elapsed,
+                 (unsigned long)stats.helperItems, (unsigned long)stats.items);
+        TEST_MESSAGE(line);
+    }
+}
+
+int main(int argc, char** argv) {
+    uint32_t seed = 7;
+    for (int t = 0; t < STREAM_FRAMES; t++) {
+        for (int m = 0; m < N_MFCC; m++) {
+            seed = seed * 1664525u + 1013904223u;
+            stream[t][m] = (int32_t)(seed >> 8) / 524288.0f;
+        }
+    }
+
+    UNITY_BEGIN();
+    RUN_TEST(test_every_item_runs_once_for_any_worker_count);
+    RUN_TEST(test_parallel_conv_matches_stock_and_reports_speedup);
+    RUN_TEST(test_streaming_rows_match_serial_and_report_speedup);
+    return UNITY_END();
+}